@@ -0,0 +1,136 @@
+﻿#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "Dispatcher.h"
+#include "EventScheduler.h"
+#include "Scene.h"
+#include "Simulation.h"
+#include "Trace.h"
+
+using namespace std;
+
+// Licznik wszystkich wywołań operatora new w programie.
+static atomic<uint64_t> allocations{ 0 };
+
+static void* Allocate(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    allocations.fetch_add(1, memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    allocations.fetch_add(1, memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { free(p); }
+
+namespace {
+
+const uint32_t WARMUP = 30 * 60 * 1000;
+const uint32_t MEASURED = 90 * 60 * 1000;
+const size_t PASSENGER_RESERVE = 4096;
+const size_t PUBLISHED_PER_FLOOR = 64;
+
+struct CheckResult {
+    uint64_t steps = 0;
+    uint64_t allocations = 0;
+    uint64_t publishAllocations = 0;
+};
+
+// Po rozgrzewce (pula pasażerów, kolejki i bufory dyspozytora osiągają swój rozmiar) liczy przydziały
+// pamięci w kolejnych krokach symulacji i w zapisie stanu do narysowania po każdym kroku (CaptureScene,
+// jak przy publikacji w SimulationThread).
+CheckResult RunScenario(const char* dispatcherName, BoardingKernel kernel, bool fixedTick, TrafficPattern pattern) {
+    BuildingConfig config;
+    config.floorCount = 20;
+    config.carCount = 4;
+    config.boardingKernel = kernel;
+    ManualClock clock;
+    ElevatorBank bank(clock, config, CreateDispatcher(dispatcherName));
+    bank.Reserve(PASSENGER_RESERVE);
+    TrafficGenerator source(pattern, config.floorCount, 1200.0, WARMUP + MEASURED, 1);
+
+    CheckResult result;
+    uint32_t end = WARMUP + MEASURED;
+    SceneState state;
+    auto publish = [&](bool measured) {
+        uint64_t before = allocations.load(memory_order_relaxed);
+        CaptureScene(bank, PUBLISHED_PER_FLOOR, state);
+        if (measured) result.publishAllocations += allocations.load(memory_order_relaxed) - before;
+    };
+    if (fixedTick) {
+        TraceRecord next;
+        bool hasNext = source.Next(next);
+        while (clock.Now() < end) {
+            bool measured = clock.Now() >= WARMUP;
+            uint64_t before = allocations.load(memory_order_relaxed);
+            while (hasNext && next.time <= clock.Now()) {
+                bank.AddPassenger(config.FloorFromLabel(next.startFloor), config.FloorFromLabel(next.targetFloor), next.time);
+                hasNext = source.Next(next);
+            }
+            clock.Advance(TICK_DURATION);
+            bank.MoveElevator();
+            if (measured) {
+                result.allocations += allocations.load(memory_order_relaxed) - before;
+                result.steps++;
+            }
+            publish(measured);
+        }
+    }
+    else {
+        EventScheduler scheduler(bank, clock);
+        scheduler.SetArrivalSource(&source);
+        scheduler.Run(WARMUP);
+        publish(false);
+        while (clock.Now() < end) {
+            uint64_t before = allocations.load(memory_order_relaxed);
+            if (!scheduler.Step()) break;
+            result.allocations += allocations.load(memory_order_relaxed) - before;
+            result.steps++;
+            publish(true);
+        }
+    }
+    return result;
+}
+
+}
+
+// Sprawdza, że krok symulacji nie przydziela pamięci: wszystkie struktury są przygotowane z góry
+// albo używane ponownie. Kończy się kodem 1, gdy w którymś wariancie pojawi się choć jeden przydział.
+int main() {
+    const char* dispatchers[] = { "nearest", "eta", "destination" };
+    const BoardingKernel kernels[] = { BoardingKernel::AOS, BoardingKernel::SCALAR };
+    const TrafficPattern patterns[] = { TrafficPattern::LUNCH, TrafficPattern::INTERFLOOR };
+
+    printf("%-12s %-8s %-6s %-8s %10s %10s %10s\n", "dyspozytor", "wariant", "tryb", "ruch", "kroki", "przydziały", "publikacja");
+    bool failed = false;
+    for (const char* dispatcher : dispatchers) {
+        for (BoardingKernel kernel : kernels) {
+            for (bool fixedTick : { true, false }) {
+                for (TrafficPattern pattern : patterns) {
+                    CheckResult result = RunScenario(dispatcher, kernel, fixedTick, pattern);
+                    printf("%-12s %-8s %-6s %-8s %10llu %10llu %10llu\n", dispatcher, BoardingKernelName(kernel), fixedTick ? "tick" : "event",
+                        TrafficPatternName(pattern), (unsigned long long)result.steps, (unsigned long long)result.allocations,
+                        (unsigned long long)result.publishAllocations);
+                    if (result.allocations > 0 || result.publishAllocations > 0) failed = true;
+                }
+            }
+        }
+    }
+    if (failed) fprintf(stderr, "Krok symulacji albo zapis stanu przydziela pamięć\n");
+    return failed ? 1 : 0;
+}
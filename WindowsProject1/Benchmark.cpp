@@ -0,0 +1,290 @@
+﻿#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+void BenchmarkState::PauseTiming() {
+    if (!running) return;
+    seconds += chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    running = false;
+}
+
+void BenchmarkState::ResumeTiming() {
+    if (running) return;
+    started = chrono::steady_clock::now();
+    running = true;
+}
+
+Benchmark* Benchmark::Args(const vector<int64_t>& args) {
+    argSets.push_back(args);
+    return this;
+}
+
+Benchmark* Benchmark::ArgsProduct(const vector<vector<int64_t>>& lists) {
+    vector<size_t> index(lists.size(), 0);
+    while (true) {
+        vector<int64_t> args;
+        for (size_t i = 0; i < lists.size(); ++i) args.push_back(lists[i][index[i]]);
+        argSets.push_back(args);
+        size_t i = lists.size();
+        while (i > 0 && ++index[i - 1] == lists[i - 1].size()) index[--i] = 0;
+        if (i == 0) return this;
+    }
+}
+
+Benchmark* Benchmark::ArgNames(const vector<string>& names) {
+    argNames = names;
+    return this;
+}
+
+Benchmark* Benchmark::Iterations(uint64_t iterations) {
+    fixedIterations = iterations;
+    return this;
+}
+
+string Benchmark::InstanceName(const vector<int64_t>& args) const {
+    string result = name;
+    for (size_t i = 0; i < args.size(); ++i) {
+        result += "/";
+        if (i < argNames.size()) result += argNames[i] + ":";
+        result += to_string(args[i]);
+    }
+    return result;
+}
+
+static vector<unique_ptr<Benchmark>>& Registry() {
+    static vector<unique_ptr<Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+Benchmark* RegisterBenchmark(const char* name, BenchmarkFunction function) {
+    Registry().push_back(make_unique<Benchmark>(name, function));
+    return Registry().back().get();
+}
+
+void WriteBenchmarkJson(FILE* out, const vector<BenchmarkResult>& results) {
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+#ifdef NDEBUG
+    const char* buildType = "release";
+#else
+    const char* buildType = "debug";
+#endif
+    fprintf(out, "{\n  \"context\": {\n");
+    fprintf(out, "    \"date\": \"%s\",\n", date);
+    fprintf(out, "    \"num_cpus\": %u,\n", thread::hardware_concurrency());
+    fprintf(out, "    \"library_build_type\": \"%s\"\n  },\n", buildType);
+    fprintf(out, "  \"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        fprintf(out, "%s\n    {\n", i ? "," : "");
+        fprintf(out, "      \"name\": \"%s\",\n", r.name.c_str());
+        fprintf(out, "      \"iterations\": %llu,\n", (unsigned long long)r.iterations);
+        fprintf(out, "      \"real_time\": %.6g,\n", r.realTime);
+        fprintf(out, "      \"real_time_stddev\": %.6g,\n", r.stddev);
+        fprintf(out, "      \"time_unit\": \"ns\"");
+        if (r.itemsPerSecond > 0.0) fprintf(out, ",\n      \"items_per_second\": %.6g", r.itemsPerSecond);
+        fprintf(out, "\n    }");
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+
+// Wystarcza do plików z WriteBenchmarkJson i z Google Benchmark: kolejne "name" i najbliższe po nim "real_time".
+bool ReadBenchmarkJson(const string& path, vector<BenchmarkResult>& results, string& error) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        error = "Nie można otworzyć " + path;
+        return false;
+    }
+    stringstream buffer;
+    buffer << in.rdbuf();
+    string text = buffer.str();
+
+    size_t pos = text.find("\"benchmarks\"");
+    if (pos == string::npos) {
+        error = "Brak listy \"benchmarks\" w " + path;
+        return false;
+    }
+    results.clear();
+    while ((pos = text.find("\"name\"", pos)) != string::npos) {
+        size_t open = text.find('"', text.find(':', pos) + 1);
+        size_t close = text.find('"', open + 1);
+        if (open == string::npos || close == string::npos) break;
+        BenchmarkResult result;
+        result.name = text.substr(open + 1, close - open - 1);
+        size_t next = text.find("\"name\"", close);
+        size_t time = text.find("\"real_time\"", close);
+        if (time != string::npos && time < next) {
+            result.realTime = strtod(text.c_str() + text.find(':', time) + 1, nullptr);
+            results.push_back(result);
+        }
+        pos = close;
+    }
+    if (results.empty()) {
+        error = "Brak pomiarów w " + path;
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+struct Options {
+    string filter;
+    double minTime = 0.2;
+    int repetitions = 1;
+    const char* jsonPath = nullptr;
+    const char* comparePath = nullptr;
+    double threshold = 10.0;
+};
+
+// Jeden wariant: liczba obrotów rośnie (najwyżej 10 razy na próbę), aż pomiar trwa co najmniej minTime.
+// Gdy przygotowanie poza pomiarem trwa dużo dłużej niż sam pomiar, dobieranie kończy się po 10 * minTime.
+BenchmarkResult RunInstance(const Benchmark& benchmark, const vector<int64_t>& args, const Options& options) {
+    uint64_t iterations = benchmark.FixedIterations() ? benchmark.FixedIterations() : 1;
+    if (!benchmark.FixedIterations()) {
+        while (true) {
+            BenchmarkState state(args, iterations);
+            auto started = chrono::steady_clock::now();
+            benchmark.Function()(state);
+            double seconds = state.Seconds();
+            double wall = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+            if (seconds >= options.minTime || wall >= 10 * options.minTime || iterations >= 1000000000) break;
+            double multiplier = seconds > 0.0 ? options.minTime * 1.4 / seconds : 10.0;
+            multiplier = min(10.0, max(multiplier, 1.1));
+            iterations = (uint64_t)ceil(iterations * multiplier);
+        }
+    }
+
+    vector<double> times;
+    uint64_t items = 0;
+    double seconds = 0.0;
+    for (int r = 0; r < options.repetitions; ++r) {
+        BenchmarkState state(args, iterations);
+        benchmark.Function()(state);
+        times.push_back(state.Seconds() * 1e9 / iterations);
+        items += state.ItemsProcessed();
+        seconds += state.Seconds();
+    }
+
+    BenchmarkResult result;
+    result.name = benchmark.InstanceName(args);
+    result.iterations = iterations;
+    double mean = 0.0;
+    for (double t : times) mean += t / times.size();
+    for (double t : times) result.stddev += (t - mean) * (t - mean) / times.size();
+    result.stddev = sqrt(result.stddev);
+    sort(times.begin(), times.end());
+    result.realTime = times[times.size() / 2];
+    result.itemsPerSecond = seconds > 0.0 ? items / seconds : 0.0;
+    return result;
+}
+
+string FormatTime(double ns) {
+    char text[32];
+    if (ns >= 1e9) snprintf(text, sizeof(text), "%.3f s", ns / 1e9);
+    else if (ns >= 1e6) snprintf(text, sizeof(text), "%.3f ms", ns / 1e6);
+    else if (ns >= 1e3) snprintf(text, sizeof(text), "%.3f us", ns / 1e3);
+    else snprintf(text, sizeof(text), "%.1f ns", ns);
+    return text;
+}
+
+bool Compare(const vector<BenchmarkResult>& results, const Options& options) {
+    vector<BenchmarkResult> baseline;
+    string error;
+    if (!ReadBenchmarkJson(options.comparePath, baseline, error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+    printf("\n%-56s %12s %12s %9s\n", "pomiar", "bazowy", "teraz", "zmiana");
+    bool regressed = false;
+    size_t unmatched = 0;
+    for (const auto& r : results) {
+        auto it = find_if(baseline.begin(), baseline.end(), [&](const BenchmarkResult& b) { return b.name == r.name; });
+        // Pomiar bez wyniku bazowego (nowy, o zmienionej nazwie albo z uszkodzonym wpisem) nie przechodzi po cichu.
+        if (it == baseline.end() || !(it->realTime > 0.0)) {
+            printf("%-56s %12s %12s %9s  %s\n", r.name.c_str(), "-", FormatTime(r.realTime).c_str(), "-",
+                it == baseline.end() ? "BRAK W BAZOWYM" : "BŁĘDNY WPIS BAZOWY");
+            unmatched++;
+            continue;
+        }
+        double change = (r.realTime - it->realTime) / it->realTime * 100.0;
+        bool slower = change > options.threshold;
+        regressed |= slower;
+        printf("%-56s %12s %12s %+8.1f%%%s\n", r.name.c_str(), FormatTime(it->realTime).c_str(), FormatTime(r.realTime).c_str(),
+            change, slower ? "  REGRESJA" : "");
+    }
+    // Wpisy bazowe pasujące do --filter, których nie zmierzono, to zwykle pomiar usunięty albo przemianowany.
+    regex filter(options.filter.empty() ? "." : options.filter);
+    for (const auto& b : baseline) {
+        if (!regex_search(b.name, filter)) continue;
+        auto it = find_if(results.begin(), results.end(), [&](const BenchmarkResult& r) { return r.name == b.name; });
+        if (it == results.end()) fprintf(stderr, "Ostrzeżenie: pomiar %s z pliku bazowego nie został wykonany\n", b.name.c_str());
+    }
+    fflush(stdout);
+    if (regressed) fprintf(stderr, "Pomiary wolniejsze od bazowych o więcej niż %.1f%%\n", options.threshold);
+    if (unmatched > 0) fprintf(stderr, "Pomiary bez poprawnego wyniku bazowego: %zu\n", unmatched);
+    return !regressed && unmatched == 0;
+}
+
+}
+
+int RunBenchmarks(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if (arg == "--min-time" && hasValue) options.minTime = atof(argv[++i]);
+        else if (arg == "--repetitions" && hasValue) options.repetitions = max(1, atoi(argv[++i]));
+        else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+        else if (arg == "--compare" && hasValue) options.comparePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) options.threshold = atof(argv[++i]);
+        else {
+            fprintf(stderr, "Użycie: %s [--filter WZORZEC] [--min-time S] [--repetitions N] [--json plik]\n"
+                "          [--compare plik_bazowy.json] [--threshold PROCENT]\n", argv[0]);
+            return 1;
+        }
+    }
+    regex filter(options.filter.empty() ? "." : options.filter);
+
+    vector<BenchmarkResult> results;
+    printf("%-56s %12s %12s %14s\n", "pomiar", "czas", "obroty", "elementy/s");
+    for (const auto& benchmark : Registry()) {
+        vector<vector<int64_t>> argSets = benchmark->ArgSets();
+        if (argSets.empty()) argSets.push_back({});
+        for (const auto& args : argSets) {
+            if (!regex_search(benchmark->InstanceName(args), filter)) continue;
+            BenchmarkResult result = RunInstance(*benchmark, args, options);
+            char items[32] = "";
+            if (result.itemsPerSecond > 0.0) snprintf(items, sizeof(items), "%.4g", result.itemsPerSecond);
+            printf("%-56s %12s %12llu %14s\n", result.name.c_str(), FormatTime(result.realTime).c_str(),
+                (unsigned long long)result.iterations, items);
+            fflush(stdout);
+            results.push_back(result);
+        }
+    }
+
+    if (options.jsonPath) {
+        FILE* out = fopen(options.jsonPath, "w");
+        if (!out) {
+            fprintf(stderr, "Nie można zapisać %s\n", options.jsonPath);
+            return 1;
+        }
+        WriteBenchmarkJson(out, results);
+        fclose(out);
+    }
+    if (options.comparePath && !Compare(results, options)) return 1;
+    return 0;
+}
@@ -0,0 +1,110 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Pomiar w stylu Google Benchmark bez zależności zewnętrznych. Funkcja pomiaru przygotowuje stan,
+// a mierzona jest tylko pętla for (auto _ : state); liczba obrotów jest dobierana tak, żeby pomiar
+// trwał co najmniej --min-time sekund.
+class BenchmarkState {
+public:
+    struct Value {};
+
+    class Iterator {
+    public:
+        Iterator(BenchmarkState* state, uint64_t remaining) : state(state), remaining(remaining) {}
+        Value operator*() const { return Value(); }
+        Iterator& operator++() {
+            remaining--;
+            return *this;
+        }
+        bool operator!=(const Iterator&) {
+            if (remaining > 0) return true;
+            state->PauseTiming();
+            return false;
+        }
+
+    private:
+        BenchmarkState* state;
+        uint64_t remaining;
+    };
+
+    BenchmarkState(const std::vector<int64_t>& args, uint64_t iterations) : args(args), iterations(iterations) {}
+
+    Iterator begin() {
+        ResumeTiming();
+        return Iterator(this, iterations);
+    }
+    Iterator end() { return Iterator(this, 0); }
+
+    int64_t Range(size_t index) const { return args[index]; }
+    uint64_t Iterations() const { return iterations; }
+    // Przygotowanie danych w trakcie pętli nie wlicza się do czasu.
+    void PauseTiming();
+    void ResumeTiming();
+    void SetItemsProcessed(uint64_t items) { this->items = items; }
+    uint64_t ItemsProcessed() const { return items; }
+    double Seconds() const { return seconds; }
+
+private:
+    std::vector<int64_t> args;
+    uint64_t iterations;
+    uint64_t items = 0;
+    double seconds = 0.0;
+    bool running = false;
+    std::chrono::steady_clock::time_point started;
+};
+
+typedef void (*BenchmarkFunction)(BenchmarkState& state);
+
+class Benchmark {
+public:
+    Benchmark(const std::string& name, BenchmarkFunction function) : name(name), function(function) {}
+
+    Benchmark* Args(const std::vector<int64_t>& args);
+    // Wszystkie kombinacje wartości z kolejnych list.
+    Benchmark* ArgsProduct(const std::vector<std::vector<int64_t>>& lists);
+    Benchmark* ArgNames(const std::vector<std::string>& names);
+    // Pomiary z kosztownym przygotowaniem (np. cała symulacja) wykonują stałą liczbę obrotów.
+    Benchmark* Iterations(uint64_t iterations);
+
+    const std::string& Name() const { return name; }
+    BenchmarkFunction Function() const { return function; }
+    const std::vector<std::vector<int64_t>>& ArgSets() const { return argSets; }
+    // Nazwa jednego wariantu, np. BM_MoveElevator/passengers:1000/floors:20.
+    std::string InstanceName(const std::vector<int64_t>& args) const;
+    uint64_t FixedIterations() const { return fixedIterations; }
+
+private:
+    std::string name;
+    BenchmarkFunction function;
+    std::vector<std::vector<int64_t>> argSets;
+    std::vector<std::string> argNames;
+    uint64_t fixedIterations = 0;
+};
+
+Benchmark* RegisterBenchmark(const char* name, BenchmarkFunction function);
+
+#define BENCHMARK_CONCAT(a, b) a##b
+#define BENCHMARK_NAME(line) BENCHMARK_CONCAT(benchmarkRegistration, line)
+#define BENCHMARK(function) static Benchmark* BENCHMARK_NAME(__LINE__) = RegisterBenchmark(#function, function)
+
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations = 0;
+    // Mediana z powtórzeń, ns na obrót.
+    double realTime = 0.0;
+    double stddev = 0.0;
+    double itemsPerSecond = 0.0;
+};
+
+void WriteBenchmarkJson(FILE* out, const std::vector<BenchmarkResult>& results);
+// Czyta "name" i "real_time" z pliku JSON zapisanego przez --json (albo przez Google Benchmark).
+bool ReadBenchmarkJson(const std::string& path, std::vector<BenchmarkResult>& results, std::string& error);
+
+// Opcje: --filter WZORZEC, --min-time S, --repetitions N, --json plik, --compare plik_bazowy, --threshold PROCENT.
+// Przy --compare zwraca 1, gdy któryś pomiar jest wolniejszy od bazowego o więcej niż próg.
+int RunBenchmarks(int argc, char** argv);
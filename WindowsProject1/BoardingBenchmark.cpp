@@ -0,0 +1,58 @@
+﻿#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "BoardingKernel.h"
+#include "Simulation.h"
+
+using namespace std;
+
+// Mierzy krok animacji wsiadania dla wielu pasażerów naraz (np. ewakuacja) i sprawdza,
+// czy warianty wektorowe dają te same pozycje co wariant skalarny.
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? atoi(argv[1]) : 200;
+    const int agentCounts[] = { 100, 1000, 10000, 100000 };
+    const BoardingKernel kernels[] = { BoardingKernel::SCALAR, BoardingKernel::SSE, BoardingKernel::AVX2 };
+
+    printf("%-8s %8s %14s %10s\n", "wariant", "osoby", "ns/osobę/krok", "zgodność");
+    for (int agents : agentCounts) {
+        mt19937 rng(agents);
+        uniform_real_distribution<float> xDist(0.0f, 600.0f);
+        uniform_real_distribution<float> yDist(0.0f, 2000.0f);
+        vector<float> startX(agents), startY(agents), targetX(agents), targetY(agents);
+        for (int i = 0; i < agents; ++i) {
+            startX[i] = xDist(rng);
+            startY[i] = yDist(rng);
+            targetX[i] = xDist(rng);
+            targetY[i] = yDist(rng);
+        }
+
+        vector<float> referenceX, referenceY;
+        for (BoardingKernel kernel : kernels) {
+            if (!IsBoardingKernelSupported(kernel)) {
+                printf("%-8s %8d %14s %10s\n", BoardingKernelName(kernel), agents, "-", "brak");
+                continue;
+            }
+            vector<float> x = startX, y = startY;
+            vector<uint8_t> arrived(agents);
+            size_t done = 0;
+            auto start = chrono::steady_clock::now();
+            for (int step = 0; step < steps; ++step) {
+                done = StepBoarding(kernel, x.data(), y.data(), targetX.data(), targetY.data(), arrived.data(), agents, BOARDING_SPEED);
+            }
+            double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ((double)steps * agents);
+
+            if (kernel == BoardingKernel::SCALAR) {
+                referenceX = x;
+                referenceY = y;
+            }
+            bool same = !memcmp(x.data(), referenceX.data(), x.size() * sizeof(float))
+                && !memcmp(y.data(), referenceY.data(), y.size() * sizeof(float));
+            printf("%-8s %8d %14.2f %10s   (%zu w celu)\n", BoardingKernelName(kernel), agents, ns, same ? "tak" : "NIE", done);
+        }
+    }
+    return 0;
+}
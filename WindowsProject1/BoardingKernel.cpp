@@ -0,0 +1,193 @@
+﻿#include "BoardingKernel.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BOARDING_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BOARDING_AVX2_TARGET
+#else
+#define BOARDING_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+using namespace std;
+
+void BoardingBatch::Add(int passengerSlot, float startX, float startY) {
+    slot.push_back(passengerSlot);
+    x.push_back(startX);
+    y.push_back(startY);
+    targetX.push_back(0.0f);
+    targetY.push_back(0.0f);
+    arrived.push_back(0);
+}
+
+void BoardingBatch::Reserve(size_t count) {
+    slot.reserve(count);
+    x.reserve(count);
+    y.reserve(count);
+    targetX.reserve(count);
+    targetY.reserve(count);
+    arrived.reserve(count);
+}
+
+void BoardingBatch::Resize(size_t count) {
+    slot.resize(count);
+    x.resize(count);
+    y.resize(count);
+    targetX.resize(count);
+    targetY.resize(count);
+    arrived.resize(count);
+}
+
+// Ta sama kolejność działań co w wektorach: mnożenia, suma, pierwiastek, a przesunięcie jako (speed * dx) / dist.
+static size_t StepBoardingScalar(float* x, float* y, const float* targetX, const float* targetY,
+    uint8_t* arrived, size_t begin, size_t count, float speed) {
+    size_t done = 0;
+    for (size_t i = begin; i < count; ++i) {
+        float dx = targetX[i] - x[i];
+        float dy = targetY[i] - y[i];
+        float dist = sqrt(dx * dx + dy * dy);
+        if (dist < speed) {
+            x[i] = targetX[i];
+            y[i] = targetY[i];
+            arrived[i] = 1;
+            done++;
+        }
+        else {
+            x[i] += speed * dx / dist;
+            y[i] += speed * dy / dist;
+            arrived[i] = 0;
+        }
+    }
+    return done;
+}
+
+#ifdef BOARDING_X86
+static size_t StoreArrived(uint8_t* arrived, int mask, int lanes) {
+    size_t done = 0;
+    for (int lane = 0; lane < lanes; ++lane) {
+        arrived[lane] = (mask >> lane) & 1;
+        done += arrived[lane];
+    }
+    return done;
+}
+
+static size_t StepBoardingSse(float* x, float* y, const float* targetX, const float* targetY,
+    uint8_t* arrived, size_t count, float speed) {
+    const __m128 s = _mm_set1_ps(speed);
+    size_t done = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 tx = _mm_loadu_ps(targetX + i);
+        __m128 ty = _mm_loadu_ps(targetY + i);
+        __m128 dx = _mm_sub_ps(tx, px);
+        __m128 dy = _mm_sub_ps(ty, py);
+        __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 nx = _mm_add_ps(px, _mm_div_ps(_mm_mul_ps(s, dx), dist));
+        __m128 ny = _mm_add_ps(py, _mm_div_ps(_mm_mul_ps(s, dy), dist));
+        __m128 reached = _mm_cmplt_ps(dist, s);
+        _mm_storeu_ps(x + i, _mm_or_ps(_mm_and_ps(reached, tx), _mm_andnot_ps(reached, nx)));
+        _mm_storeu_ps(y + i, _mm_or_ps(_mm_and_ps(reached, ty), _mm_andnot_ps(reached, ny)));
+        done += StoreArrived(arrived + i, _mm_movemask_ps(reached), 4);
+    }
+    return done + StepBoardingScalar(x, y, targetX, targetY, arrived, i, count, speed);
+}
+
+BOARDING_AVX2_TARGET
+static size_t StepBoardingAvx2(float* x, float* y, const float* targetX, const float* targetY,
+    uint8_t* arrived, size_t count, float speed) {
+    const __m256 s = _mm256_set1_ps(speed);
+    size_t done = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 tx = _mm256_loadu_ps(targetX + i);
+        __m256 ty = _mm256_loadu_ps(targetY + i);
+        __m256 dx = _mm256_sub_ps(tx, px);
+        __m256 dy = _mm256_sub_ps(ty, py);
+        __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        __m256 nx = _mm256_add_ps(px, _mm256_div_ps(_mm256_mul_ps(s, dx), dist));
+        __m256 ny = _mm256_add_ps(py, _mm256_div_ps(_mm256_mul_ps(s, dy), dist));
+        __m256 reached = _mm256_cmp_ps(dist, s, _CMP_LT_OQ);
+        _mm256_storeu_ps(x + i, _mm256_blendv_ps(nx, tx, reached));
+        _mm256_storeu_ps(y + i, _mm256_blendv_ps(ny, ty, reached));
+        done += StoreArrived(arrived + i, _mm256_movemask_ps(reached), 8);
+    }
+    return done + StepBoardingScalar(x, y, targetX, targetY, arrived, i, count, speed);
+}
+
+static bool CpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool avx = (info[2] & (1 << 28)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!avx || !osxsave || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+bool IsBoardingKernelSupported(BoardingKernel kernel) {
+    switch (kernel) {
+#ifdef BOARDING_X86
+    case BoardingKernel::SSE: return true;
+    case BoardingKernel::AVX2: {
+        static const bool avx2 = CpuHasAvx2();
+        return avx2;
+    }
+#else
+    case BoardingKernel::SSE:
+    case BoardingKernel::AVX2: return false;
+#endif
+    default: return true;
+    }
+}
+
+BoardingKernel BestBoardingKernel() {
+    if (IsBoardingKernelSupported(BoardingKernel::AVX2)) return BoardingKernel::AVX2;
+    if (IsBoardingKernelSupported(BoardingKernel::SSE)) return BoardingKernel::SSE;
+    return BoardingKernel::SCALAR;
+}
+
+size_t StepBoarding(BoardingKernel kernel, float* x, float* y, const float* targetX, const float* targetY,
+    uint8_t* arrived, size_t count, float speed) {
+    if (kernel == BoardingKernel::AUTO || !IsBoardingKernelSupported(kernel)) kernel = BestBoardingKernel();
+#ifdef BOARDING_X86
+    if (kernel == BoardingKernel::AVX2) return StepBoardingAvx2(x, y, targetX, targetY, arrived, count, speed);
+    if (kernel == BoardingKernel::SSE) return StepBoardingSse(x, y, targetX, targetY, arrived, count, speed);
+#endif
+    return StepBoardingScalar(x, y, targetX, targetY, arrived, 0, count, speed);
+}
+
+const char* BoardingKernelName(BoardingKernel kernel) {
+    switch (kernel) {
+    case BoardingKernel::AOS: return "aos";
+    case BoardingKernel::SCALAR: return "scalar";
+    case BoardingKernel::SSE: return "sse";
+    case BoardingKernel::AVX2: return "avx2";
+    case BoardingKernel::AUTO: return "auto";
+    }
+    return "?";
+}
+
+bool ParseBoardingKernel(const string& name, BoardingKernel& kernel) {
+    for (BoardingKernel k : { BoardingKernel::AOS, BoardingKernel::SCALAR, BoardingKernel::SSE, BoardingKernel::AVX2, BoardingKernel::AUTO }) {
+        if (name == BoardingKernelName(k)) {
+            kernel = k;
+            return true;
+        }
+    }
+    return false;
+}
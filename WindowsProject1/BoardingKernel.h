@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sposób liczenia animacji wsiadania. AOS przechodzi po liście pasażerów kabiny,
+// pozostałe tryby używają BoardingBatch i różnią się tylko zestawem instrukcji.
+enum class BoardingKernel {
+    AOS,
+    SCALAR,
+    SSE,
+    AVX2,
+    AUTO
+};
+
+// Wsiadający pasażerowie wszystkich kabin w osobnych, ciągłych tablicach.
+struct BoardingBatch {
+    std::vector<int> slot;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> targetX;
+    std::vector<float> targetY;
+    std::vector<uint8_t> arrived;
+
+    size_t Size() const { return slot.size(); }
+    void Add(int passengerSlot, float startX, float startY);
+    void Resize(size_t count);
+    void Reserve(size_t count);
+};
+
+// Przesuwa każdy punkt o speed w stronę celu, a gdy jest bliżej niż speed, ustawia go w celu
+// i zaznacza arrived. Wszystkie warianty dają wyniki identyczne bit w bit. Zwraca liczbę punktów w celu.
+size_t StepBoarding(BoardingKernel kernel, float* x, float* y, const float* targetX, const float* targetY,
+    uint8_t* arrived, size_t count, float speed);
+
+BoardingKernel BestBoardingKernel();
+bool IsBoardingKernelSupported(BoardingKernel kernel);
+const char* BoardingKernelName(BoardingKernel kernel);
+bool ParseBoardingKernel(const std::string& name, BoardingKernel& kernel);
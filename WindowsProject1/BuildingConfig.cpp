@@ -0,0 +1,143 @@
+﻿#include "BuildingConfig.h"
+
+#include <cstdlib>
+#include <fstream>
+
+using namespace std;
+
+static string Trim(const string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+bool LoadBuildingConfig(const string& path, BuildingConfig& config, string& error) {
+    ifstream in(path);
+    if (!in) {
+        error = "nie można otworzyć pliku " + path;
+        return false;
+    }
+
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        line = Trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        size_t eq = line.find('=');
+        if (eq == string::npos) {
+            error = path + ":" + to_string(lineNumber) + ": brak znaku '='";
+            return false;
+        }
+        if (!SetBuildingConfigValue(config, Trim(line.substr(0, eq)), Trim(line.substr(eq + 1)), error)) {
+            error = path + ":" + to_string(lineNumber) + ": " + error;
+            return false;
+        }
+    }
+    return ValidateBuildingConfig(config, error);
+}
+
+bool SetBuildingConfigValue(BuildingConfig& config, const string& key, const string& value, string& error) {
+    const char* v = value.c_str();
+    if (key == "floors") config.floorCount = atoi(v);
+    else if (key == "floor_height") config.floorHeight = atoi(v);
+    else if (key == "max_weight") config.maxWeight = (float)atof(v);
+    else if (key == "weight_per_person") config.weightPerPerson = (float)atof(v);
+    else if (key == "speed") config.elevatorSpeed = (float)atof(v);
+    else if (key == "door_open_ms") config.doorOpenDuration = (uint32_t)strtoul(v, nullptr, 10);
+    else if (key == "full_threshold") config.fullElevatorThreshold = atoi(v);
+    else if (key == "idle_return_ms") config.idleReturnDelay = (uint32_t)strtoul(v, nullptr, 10);
+    else if (key == "cars") config.carCount = atoi(v);
+    else if (key == "boarding") {
+        if (!ParseBoardingKernel(value, config.boardingKernel)) {
+            error = "nieznany tryb wsiadania '" + value + "'";
+            return false;
+        }
+    }
+    else if (key == "motion") {
+        if (!ParseMotionModel(value, config.motionModel)) {
+            error = "nieznany model ruchu '" + value + "'";
+            return false;
+        }
+    }
+    else if (key == "floor_height_m") config.floorHeightMeters = (float)atof(v);
+    else if (key == "speed_m_s") config.ratedSpeed = (float)atof(v);
+    else if (key == "acceleration_m_s2") config.acceleration = (float)atof(v);
+    else if (key == "jerk_m_s3") config.jerk = (float)atof(v);
+    else if (key == "parking") {
+        if (!ParseParkingPolicy(value, config.parkingPolicy)) {
+            error = "nieznana polityka postoju '" + value + "'";
+            return false;
+        }
+    }
+    else if (key == "demand_half_life_ms") config.demandHalfLife = (uint32_t)strtoul(v, nullptr, 10);
+    else if (key == "demand_slot_ms") config.demandSlot = (uint32_t)strtoul(v, nullptr, 10);
+    else if (key == "zone") {
+        CarZone zone;
+        if (!ParseCarZone(value, zone, error)) return false;
+        config.zones.push_back(zone);
+    }
+    else if (key == "stairs_floors") config.stairsFloors = atoi(v);
+    else if (key == "balk_queue") config.balkQueue = atoi(v);
+    else if (key == "patience_ms") config.patience = (uint32_t)strtoul(v, nullptr, 10);
+    else if (key == "walk_speed") config.walkSpeed = (float)atof(v);
+    else {
+        error = "nieznany klucz '" + key + "'";
+        return false;
+    }
+    return true;
+}
+
+// Każda kabina w co najwyżej jednej strefie i każde piętro osiągalne z każdego z co najwyżej jedną przesiadką.
+static bool ValidateZones(const BuildingConfig& config, string& error) {
+    if (config.zones.empty()) return true;
+    vector<char> zoned(config.carCount, 0);
+    for (const auto& zone : config.zones) {
+        if (zone.lastCar >= config.carCount) {
+            error = "strefa obejmuje kabinę " + to_string(zone.lastCar) + ", a kabin jest " + to_string(config.carCount);
+            return false;
+        }
+        for (int car = zone.firstCar; car <= zone.lastCar; ++car) {
+            if (zoned[car]) {
+                error = "kabina " + to_string(car) + " jest w dwóch strefach";
+                return false;
+            }
+            zoned[car] = 1;
+        }
+        for (int label : zone.floors) {
+            if (label >= config.floorCount) {
+                error = "strefa obejmuje piętro " + to_string(label) + ", a pięter jest " + to_string(config.floorCount);
+                return false;
+            }
+        }
+    }
+    int start, target;
+    if (ZoneRoutes(config.floorCount, config.carCount, config.zones).FindUnreachable(start, target)) {
+        error = "strefy nie prowadzą z piętra " + to_string(config.GroundFloor() - start) + " na piętro "
+            + to_string(config.GroundFloor() - target) + " z jedną przesiadką";
+        return false;
+    }
+    return true;
+}
+
+bool ValidateBuildingConfig(const BuildingConfig& config, string& error) {
+    if (config.floorCount < 2) error = "floors musi być >= 2";
+    else if (config.floorHeight < 1) error = "floor_height musi być >= 1";
+    else if (config.weightPerPerson <= 0 || config.maxWeight < config.weightPerPerson) error = "max_weight musi mieścić co najmniej jedną osobę";
+    else if (config.elevatorSpeed <= 0) error = "speed musi być > 0";
+    else if (config.fullElevatorThreshold < 1) error = "full_threshold musi być >= 1";
+    else if (config.carCount < 1) error = "cars musi być >= 1";
+    else if (config.floorHeightMeters <= 0) error = "floor_height_m musi być > 0";
+    else if (config.ratedSpeed <= 0) error = "speed_m_s musi być > 0";
+    else if (config.acceleration <= 0) error = "acceleration_m_s2 musi być > 0";
+    else if (config.jerk <= 0) error = "jerk_m_s3 musi być > 0";
+    else if (config.demandHalfLife == 0) error = "demand_half_life_ms musi być > 0";
+    else if (config.stairsFloors < 0) error = "stairs_floors musi być >= 0";
+    else if (config.balkQueue < 0) error = "balk_queue musi być >= 0";
+    else if (config.walkSpeed <= 0) error = "walk_speed musi być > 0";
+    else if (config.demandSlot == 0 || DemandModel::DAY % config.demandSlot != 0) error = "demand_slot_ms musi dzielić dobę (86400000)";
+    else return ValidateZones(config, error);
+    return false;
+}
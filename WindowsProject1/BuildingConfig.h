@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BoardingKernel.h"
+#include "Kinematics.h"
+#include "Parking.h"
+#include "Zones.h"
+
+// Parametry budynku i wind wczytywane przy starcie programu.
+struct BuildingConfig {
+    int floorCount = 4;
+    int floorHeight = 100;
+    float maxWeight = 600.0f;
+    float weightPerPerson = 70.0f;
+    float elevatorSpeed = 2.5f;
+    uint32_t doorOpenDuration = 1500;
+    int fullElevatorThreshold = 6;
+    uint32_t idleReturnDelay = 5000;
+    int carCount = 1;
+    BoardingKernel boardingKernel = BoardingKernel::AOS;
+    // Model ruchu kabiny. W modelu JERK elevatorSpeed nie jest używane; liczą się wymiary w metrach
+    // i ograniczenia prędkości (m/s), przyspieszenia (m/s²) i zrywu (m/s³).
+    MotionModel motionModel = MotionModel::CONSTANT;
+    float floorHeightMeters = 3.5f;
+    float ratedSpeed = 2.5f;
+    float acceleration = 1.0f;
+    float jerk = 1.5f;
+    // Postój wolnej kabiny; w polityce DEMAND model popytu zapomina ostatnie wezwania z okresem
+    // półtrwania demandHalfLife, a pora dnia jest dzielona na przedziały demandSlot (dzielnik doby).
+    ParkingPolicy parkingPolicy = ParkingPolicy::GROUND;
+    uint32_t demandHalfLife = 30u * 60u * 1000u;
+    uint32_t demandSlot = 60u * 60u * 1000u;
+    // Strefy kabin, po jednej na klucz "zone"; kabiny spoza stref obsługują wszystkie piętra.
+    std::vector<CarZone> zones;
+    // Zachowanie pasażerów; 0 wyłącza. Podróż o co najwyżej stairsFloors pięter odbywa się schodami, przy balkQueue
+    // lub więcej czekających w holu przychodzący rezygnuje z windy, a czekający na pierwszą kabinę dłużej niż
+    // patience ms odchodzi z kolejki. walkSpeed to prędkość dojścia do kabiny w pikselach na krok.
+    int stairsFloors = 0;
+    int balkQueue = 0;
+    uint32_t patience = 0;
+    float walkSpeed = 4.0f;
+
+    int GroundFloor() const { return floorCount - 1; }
+    int CarCapacity() const { return (int)(maxWeight / weightPerPerson); }
+    // Piętra w plikach ruchu i w opcjach podawane są tak jak w oknie: 0 to parter.
+    int FloorFromLabel(int label) const { return GroundFloor() - label; }
+    int GetFloorFromY(float y) const { return (int)std::round(y / floorHeight); }
+};
+
+// Plik tekstowy z liniami "klucz = wartość", np. "floors = 200". Linie zaczynające się od # są pomijane.
+bool LoadBuildingConfig(const std::string& path, BuildingConfig& config, std::string& error);
+bool ValidateBuildingConfig(const BuildingConfig& config, std::string& error);
+// Ustawia jeden parametr, klucze jak w pliku konfiguracji.
+bool SetBuildingConfigValue(BuildingConfig& config, const std::string& key, const std::string& value, std::string& error);
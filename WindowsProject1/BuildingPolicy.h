@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include "BuildingConfig.h"
+#include "FloorSet.h"
+
+// Kształt budynku widziany przez rdzeń symulacji (BasicElevatorBank). Funkcje przyjmują BuildingConfig,
+// ale budynek o stałym kształcie zwraca stałe, więc kompilator rozwija pętle po piętrach i zwija obliczenia.
+
+// Rozmiar i parametry wind z BuildingConfig, znane dopiero w czasie działania (np. wieżowiec z pliku).
+struct RuntimeBuilding {
+    typedef FloorSet FloorMask;
+
+    static BuildingConfig DefaultConfig() { return BuildingConfig(); }
+    static int FloorCount(const BuildingConfig& config) { return config.floorCount; }
+    static int FloorHeight(const BuildingConfig& config) { return config.floorHeight; }
+    static float MaxWeight(const BuildingConfig& config) { return config.maxWeight; }
+    static float WeightPerPerson(const BuildingConfig& config) { return config.weightPerPerson; }
+    static float Speed(const BuildingConfig& config) { return config.elevatorSpeed; }
+    static uint32_t DoorOpenDuration(const BuildingConfig& config) { return config.doorOpenDuration; }
+    static int FullThreshold(const BuildingConfig& config) { return config.fullElevatorThreshold; }
+    static uint32_t IdleReturnDelay(const BuildingConfig& config) { return config.idleReturnDelay; }
+    static MotionModel Motion(const BuildingConfig& config) { return config.motionModel; }
+    static ParkingPolicy Parking(const BuildingConfig& config) { return config.parkingPolicy; }
+};
+
+// Budynek o kształcie ustalonym przy kompilacji, z jedną kabiną. Shape podaje stałe FLOOR_COUNT, FLOOR_HEIGHT,
+// MAX_WEIGHT, WEIGHT_PER_PERSON, SPEED, DOOR_OPEN_DURATION, FULL_THRESHOLD, IDLE_RETURN_DELAY, MOTION i PARKING.
+// Pola config o tych samych nazwach są ignorowane; DefaultConfig() podaje pasującą konfigurację.
+template <class Shape>
+struct FixedBuilding {
+    typedef FixedFloorSet<Shape::FLOOR_COUNT> FloorMask;
+
+    static BuildingConfig DefaultConfig() {
+        BuildingConfig config;
+        config.floorCount = Shape::FLOOR_COUNT;
+        config.floorHeight = Shape::FLOOR_HEIGHT;
+        config.maxWeight = Shape::MAX_WEIGHT;
+        config.weightPerPerson = Shape::WEIGHT_PER_PERSON;
+        config.elevatorSpeed = Shape::SPEED;
+        config.doorOpenDuration = Shape::DOOR_OPEN_DURATION;
+        config.fullElevatorThreshold = Shape::FULL_THRESHOLD;
+        config.idleReturnDelay = Shape::IDLE_RETURN_DELAY;
+        config.motionModel = Shape::MOTION;
+        config.parkingPolicy = Shape::PARKING;
+        config.carCount = 1;
+        return config;
+    }
+    static constexpr int FloorCount(const BuildingConfig&) { return Shape::FLOOR_COUNT; }
+    static constexpr int FloorHeight(const BuildingConfig&) { return Shape::FLOOR_HEIGHT; }
+    static constexpr float MaxWeight(const BuildingConfig&) { return Shape::MAX_WEIGHT; }
+    static constexpr float WeightPerPerson(const BuildingConfig&) { return Shape::WEIGHT_PER_PERSON; }
+    static constexpr float Speed(const BuildingConfig&) { return Shape::SPEED; }
+    static constexpr uint32_t DoorOpenDuration(const BuildingConfig&) { return Shape::DOOR_OPEN_DURATION; }
+    static constexpr int FullThreshold(const BuildingConfig&) { return Shape::FULL_THRESHOLD; }
+    static constexpr uint32_t IdleReturnDelay(const BuildingConfig&) { return Shape::IDLE_RETURN_DELAY; }
+    static constexpr MotionModel Motion(const BuildingConfig&) { return Shape::MOTION; }
+    static constexpr ParkingPolicy Parking(const BuildingConfig&) { return Shape::PARKING; }
+};
+
+// Budynek z okna programu: 4 piętra, kabina na 8 osób (domyślne wartości BuildingConfig).
+struct FourFloorShape {
+    static constexpr int FLOOR_COUNT = 4;
+    static constexpr int FLOOR_HEIGHT = 100;
+    static constexpr float MAX_WEIGHT = 600.0f;
+    static constexpr float WEIGHT_PER_PERSON = 70.0f;
+    static constexpr float SPEED = 2.5f;
+    static constexpr uint32_t DOOR_OPEN_DURATION = 1500;
+    static constexpr int FULL_THRESHOLD = 6;
+    static constexpr uint32_t IDLE_RETURN_DELAY = 5000;
+    static constexpr MotionModel MOTION = MotionModel::CONSTANT;
+    static constexpr ParkingPolicy PARKING = ParkingPolicy::GROUND;
+};
+
+typedef FixedBuilding<FourFloorShape> FourFloorBuilding;
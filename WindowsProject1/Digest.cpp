@@ -0,0 +1,9 @@
+﻿#include "Digest.h"
+
+void WriteDigestHeader(FILE* out) {
+    fputs("time_ms,events,digest\n", out);
+}
+
+void WriteDigestRow(FILE* out, uint32_t time, const StateDigest& digest) {
+    fprintf(out, "%u,%llu,%016llx\n", (unsigned)time, (unsigned long long)digest.Events(), (unsigned long long)digest.Value());
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+enum class DigestEvent : uint8_t {
+    ARRIVAL,
+    BOARD,
+    ALIGHT,
+    STOP,
+    DIRECTION,
+    BALK,
+    RENEGE
+};
+
+// Skrót przebiegu: 64-bitowa wartość dopisywana przy każdym przyjściu, wejściu, wyjściu, postoju, zmianie kierunku
+// kabiny i rezygnacji pasażera, zamiast liczenia skrótu całego stanu od nowa. Zależy od kolejności zdarzeń, więc dwa
+// przebiegi tego samego ruchu mają ten sam skrót, dopóki zachowują się tak samo. Record to dwa mieszania, kilka ns.
+class StateDigest {
+public:
+    void Record(DigestEvent event, uint32_t time, int car, int floor, uint32_t detail) {
+        value = Mix(value ^ ((uint64_t)time << 32 | (uint64_t)event << 24 | ((uint32_t)car & 0xFFFFFF)));
+        value = Mix(value ^ ((uint64_t)(uint32_t)floor << 32 | detail));
+        events++;
+    }
+    uint64_t Value() const { return value; }
+    uint64_t Events() const { return events; }
+
+private:
+    friend struct SnapshotAccess;
+
+    // Krok splitmix64: bijekcja, w której każdy bit wejścia zmienia średnio połowę bitów wyniku.
+    static uint64_t Mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t value = 0;
+    uint64_t events = 0;
+};
+
+void WriteDigestHeader(FILE* out);
+// Jeden wiersz CSV: chwila, liczba zdarzeń od początku i skrót po nich (szesnastkowo).
+void WriteDigestRow(FILE* out, uint32_t time, const StateDigest& digest);
@@ -0,0 +1,74 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Dispatcher.h"
+#include "Simulation.h"
+
+using namespace std;
+
+// Mierzy koszt przydzielenia jednego wezwania w zależności od liczby kabin. Każda kabina ma w kolejkach
+// kilku czekających, a zegar przesuwa się przy każdym wezwaniu, więc nic nie jest brane z pamięci
+// poprzedniej decyzji. Czas 99% decyzji jest mierzony osobno, dla każdego wezwania z osobna.
+int main(int argc, char** argv) {
+    int calls = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int carCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+    const char* dispatchers[] = { "nearest", "eta", "destination" };
+    const int QUEUED_PER_CAR = 8;
+
+    printf("%-12s %6s %12s %12s\n", "dyspozytor", "kabiny", "ns/wezwanie", "p99 us");
+    for (const char* name : dispatchers) {
+        for (int carCount : carCounts) {
+            ManualClock clock;
+            BuildingConfig config;
+            config.carCount = carCount;
+            ElevatorBank bank(clock, config, CreateDispatcher(name));
+            mt19937 rng(carCount);
+            uniform_int_distribution<int> floorDist(0, config.floorCount - 1);
+            for (auto& car : bank.cars) {
+                car.elevatorY = (float)(rng() % (config.GroundFloor() * config.floorHeight));
+                car.targetFloor = floorDist(rng);
+                car.currentState = (rng() % 2) ? ElevatorState::MOVING : ElevatorState::IDLE;
+                car.currentDirection = car.currentState == ElevatorState::IDLE ? Direction::NONE
+                    : (car.targetFloor * config.floorHeight < car.elevatorY ? Direction::UP : Direction::DOWN);
+                car.assignedPassengers = rng() % 8;
+            }
+            for (int i = 0; i < QUEUED_PER_CAR * carCount; ++i) {
+                int start = floorDist(rng), target;
+                do target = floorDist(rng); while (target == start);
+                bank.AddPassenger(start, target);
+            }
+
+            vector<pair<int, int>> requests(1024);
+            for (auto& r : requests) {
+                r.first = floorDist(rng);
+                do r.second = floorDist(rng); while (r.second == r.first);
+            }
+
+            long long checksum = 0;
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < calls; ++i) {
+                const auto& r = requests[i & 1023];
+                clock.Advance(1);
+                checksum += bank.dispatcher->AssignCar(bank, r.first, r.second);
+            }
+            double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / calls;
+
+            vector<double> times(min(calls, 10000));
+            for (size_t i = 0; i < times.size(); ++i) {
+                const auto& r = requests[i & 1023];
+                clock.Advance(1);
+                auto callStart = chrono::steady_clock::now();
+                checksum += bank.dispatcher->AssignCar(bank, r.first, r.second);
+                times[i] = chrono::duration<double, micro>(chrono::steady_clock::now() - callStart).count();
+            }
+            sort(times.begin(), times.end());
+            double p99 = times.empty() ? 0.0 : times[times.size() * 99 / 100];
+            printf("%-12s %6d %12.1f %12.1f   (%lld)\n", name, carCount, ns, p99, checksum % 1000);
+        }
+    }
+    return 0;
+}
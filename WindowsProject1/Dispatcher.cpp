@@ -0,0 +1,276 @@
+#include "Dispatcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+int NearestCarDispatcher::AssignCar(const ElevatorBank& bank, int startFloor, int targetFloor) {
+    int best = -1;
+    float bestDistance = 0;
+    for (const auto& car : bank.cars) {
+        if (!bank.Serves(car, startFloor, targetFloor)) continue;
+        float distance = abs(car.elevatorY - (float)startFloor * bank.config.floorHeight);
+        if (best == -1 || distance < bestDistance) {
+            best = car.index;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+float EtaDispatcher::EstimateArrival(const BuildingConfig& config, const Elevator& car, int startFloor, int targetFloor) {
+    const TravelTime travel(config);
+    const float STOP_TIME = (float)(config.doorOpenDuration + TICK_DURATION);
+
+    float position = car.elevatorY / config.floorHeight;
+    Direction callDirection = (targetFloor < startFloor) ? Direction::UP : Direction::DOWN;
+
+    float eta;
+    if (car.currentState == ElevatorState::IDLE || car.currentDirection == Direction::NONE || car.targetFloor == -1) {
+        eta = travel(abs(position - startFloor));
+    }
+    else {
+        bool ahead = (car.currentDirection == Direction::UP) ? startFloor <= position : startFloor >= position;
+        if (ahead && callDirection == car.currentDirection) {
+            eta = travel(abs(position - startFloor));
+        }
+        else {
+            eta = travel(abs(position - car.targetFloor), abs((float)car.targetFloor - startFloor));
+        }
+    }
+
+    eta += min(car.assignedPassengers, config.floorCount) * STOP_TIME;
+    if (car.assignedPassengers >= config.fullElevatorThreshold * car.decks) eta += 2 * travel((float)(config.floorCount - 1));
+    return eta;
+}
+
+int EtaDispatcher::AssignCar(const ElevatorBank& bank, int startFloor, int targetFloor) {
+    int best = -1;
+    float bestEta = 0;
+    for (const auto& car : bank.cars) {
+        if (!bank.Serves(car, startFloor, targetFloor)) continue;
+        float eta = EstimateArrival(bank.config, car, startFloor, targetFloor);
+        if (best == -1 || eta < bestEta) {
+            best = car.index;
+            bestEta = eta;
+        }
+    }
+    return best;
+}
+
+void DestinationDispatcher::LoadWork(const ElevatorBank& bank, const Elevator& car) {
+    int floorCount = bank.config.floorCount;
+    work.ridersTo.assign(floorCount, 0);
+    work.destinations.Resize(floorCount);
+    work.inside = car.passengersInside + car.boardingPassengers;
+    work.waiting = 0;
+    for (int floor = car.destinations.floors.FirstFrom(0); floor != -1; floor = car.destinations.floors.FirstFrom(floor + 1)) {
+        work.ridersTo[floor] = car.riders[floor].size;
+        if (work.ridersTo[floor] > 0) work.destinations.Set(floor);
+    }
+    for (int slot = car.boarding.head; slot != -1; slot = bank.passengers[slot].next) {
+        int target = bank.StopFloor(car, bank.passengers[slot].targetFloor);
+        work.ridersTo[target]++;
+        work.destinations.Set(target);
+    }
+    // Kolejki wszystkich pięter w jednej tablicy o stałej pojemności. first i last są ważne tylko dla pięter
+    // z requests, więc przeglądane są tylko piętra z czekającymi.
+    int limit = MAX_QUEUE_LOADS * bank.config.CarCapacity() * car.decks;
+    work.targets.clear();
+    work.targets.reserve(2 * (size_t)floorCount * limit);
+    work.extraFloor = -1;
+    for (int d = 0; d < 2; ++d) {
+        const vector<PassengerList>& queues = d == 0 ? car.queueUp : car.queueDown;
+        const FloorSet& waiting = d == 0 ? car.waitingUp.floors : car.waitingDown.floors;
+        work.first[d].resize(floorCount);
+        work.last[d].resize(floorCount);
+        work.requests[d].Resize(floorCount);
+        work.truncated[d].Resize(floorCount);
+        for (int floor = waiting.FirstFrom(0); floor != -1; floor = waiting.FirstFrom(floor + 1)) {
+            work.first[d][floor] = (int)work.targets.size();
+            int taken = 0;
+            for (int slot = queues[floor].head; slot != -1 && taken < limit; slot = bank.passengers[slot].next, ++taken) {
+                work.targets.push_back(bank.StopFloor(car, bank.passengers[slot].targetFloor));
+            }
+            work.last[d][floor] = (int)work.targets.size();
+            work.requests[d].Set(floor);
+            if (queues[floor].size > taken) work.truncated[d].Set(floor);
+            work.waiting += queues[floor].size;
+        }
+    }
+}
+
+// Tak jak DecideNextMove: najpierw postoje przed kabiną w kierunku jazdy, potem po zawróceniu,
+// a bez kierunku najbliższe zadanie. Po postoju piętro, na którym kabina stoi, jest pomijane.
+int DestinationDispatcher::NextStop(int floor, Direction& direction, bool full, bool inclusive) const {
+    for (int i = 0; i < 2 && direction != Direction::NONE; ++i) {
+        int next;
+        if (direction == Direction::UP) {
+            int from = inclusive ? floor : floor - 1;
+            next = destinations.LastUpTo(from);
+            if (!full) next = max(next, requests[0].LastUpTo(from));
+        }
+        else {
+            int from = inclusive ? floor : floor + 1;
+            next = destinations.FirstFrom(from);
+            if (!full) {
+                int request = requests[1].FirstFrom(from);
+                if (request != -1 && (next == -1 || request < next)) next = request;
+            }
+        }
+        if (next != -1) return next;
+        direction = (direction == Direction::UP) ? Direction::DOWN : Direction::UP;
+        inclusive = true;
+    }
+
+    int next = -1;
+    auto consider = [&](const FloorSet& floors) {
+        int candidate = floors.Nearest(floor);
+        if (candidate != -1 && (next == -1 || abs(candidate - floor) < abs(next - floor))) next = candidate;
+    };
+    consider(destinations);
+    if (!full) {
+        consider(requests[0]);
+        consider(requests[1]);
+    }
+    direction = next == -1 || next == floor ? Direction::NONE : (next < floor ? Direction::UP : Direction::DOWN);
+    return next;
+}
+
+// Suma przewidywanych czasów do wyjścia z kabiny dla wszystkich jej pasażerów, liczona od teraz.
+// Kto nie wysiądzie w horyzoncie maxStops postojów, dostaje czas końca horyzontu i jeden pełny objazd budynku.
+float DestinationDispatcher::Rollout(const BuildingConfig& config, const Elevator& car, uint32_t now, int maxStops) {
+    const TravelTime travel(config);
+    const float STOP_TIME = (float)(config.doorOpenDuration + TICK_DURATION);
+    const int capacity = config.CarCapacity() * car.decks;
+    const int fullThreshold = config.fullElevatorThreshold * car.decks;
+
+    ridersTo = work.ridersTo;
+    destinations = work.destinations;
+    for (int d = 0; d < 2; ++d) {
+        requests[d] = work.requests[d];
+        cursor[d] = work.first[d];
+    }
+    int inside = work.inside;
+    int waiting = work.waiting;
+    bool extraWaiting = work.extraFloor != -1;
+
+    float position = car.elevatorY / config.floorHeight;
+    int floor = config.GetFloorFromY(car.elevatorY);
+    Direction direction = car.currentDirection;
+    float time = 0.0f;
+    int next = -1;
+    if (car.currentState == ElevatorState::STOPPED) {
+        uint32_t open = now - car.stateTimer;
+        time = (open < config.doorOpenDuration ? (float)(config.doorOpenDuration - open) : 0.0f) - STOP_TIME;
+        next = floor;
+    }
+    else if (car.currentState == ElevatorState::MOVING && car.targetFloor != -1) {
+        next = car.targetFloor;
+    }
+
+    float cost = 0.0f;
+    bool inclusive = true;
+    for (int stops = 0; stops < maxStops; ++stops) {
+        if (next == -1) next = NextStop(floor, direction, inside >= fullThreshold, inclusive);
+        if (next == -1) break;
+        time += travel(abs(position - next)) + STOP_TIME;
+        position = (float)next;
+        floor = next;
+        next = -1;
+        inclusive = false;
+
+        if (ridersTo[floor] > 0) {
+            cost += time * ridersTo[floor];
+            inside -= ridersTo[floor];
+            ridersTo[floor] = 0;
+            destinations.Reset(floor);
+        }
+
+        Direction boarding = direction;
+        if (boarding == Direction::NONE) {
+            if (requests[0].Test(floor)) boarding = Direction::UP;
+            else if (requests[1].Test(floor)) boarding = Direction::DOWN;
+        }
+        int d = boarding == Direction::UP ? 0 : 1;
+        if (boarding != Direction::NONE && requests[d].Test(floor)) {
+            auto board = [&](int target) {
+                ridersTo[target]++;
+                destinations.Set(target);
+                inside++;
+                waiting--;
+            };
+            int& first = cursor[d][floor];
+            int last = work.last[d][floor];
+            while (first < last && inside < capacity) board(work.targets[first++]);
+            // Nowy pasażer stoi na końcu kolejki, za pominiętymi w LoadWork.
+            bool truncated = work.truncated[d].Test(floor);
+            bool extraHere = extraWaiting && work.extraFloor == floor && work.extraDirection == d;
+            if (extraHere && !truncated && first == last && inside < capacity) {
+                board(work.extraTarget);
+                extraWaiting = extraHere = false;
+            }
+            if (first == last && (truncated || !extraHere)) requests[d].Reset(floor);
+        }
+        if (direction == Direction::NONE) direction = boarding;
+    }
+    float unfinished = time + 2 * travel((float)(config.floorCount - 1));
+    return cost + (inside + waiting) * unfinished;
+}
+
+int DestinationDispatcher::AssignCar(const ElevatorBank& bank, int startFloor, int targetFloor) {
+    const BuildingConfig& config = bank.config;
+    uint32_t now = bank.clock.Now();
+    int carCount = (int)bank.cars.size();
+    int d = targetFloor < startFloor ? 0 : 1;
+    baseCosts.resize(carCount);
+
+    candidates.clear();
+    for (const auto& car : bank.cars) {
+        if (!bank.Serves(car, startFloor, targetFloor)) continue;
+        float eta = carCount > MAX_CANDIDATES ? EtaDispatcher::EstimateArrival(config, car, startFloor, targetFloor) : 0.0f;
+        candidates.push_back({ eta, car.index });
+    }
+    if ((int)candidates.size() > MAX_CANDIDATES) {
+        partial_sort(candidates.begin(), candidates.begin() + MAX_CANDIDATES, candidates.end());
+        candidates.resize(MAX_CANDIDATES);
+    }
+    int maxStops = min(MAX_LOOKAHEAD_STOPS, STOP_BUDGET / (2 * (int)candidates.size()));
+
+    int best = -1;
+    float bestCost = 0.0f;
+    for (const auto& candidate : candidates) {
+        const Elevator& car = bank.cars[candidate.second];
+        LoadWork(bank, car);
+        BaseCost& base = baseCosts[car.index];
+        if (base.time != now || base.maxStops != maxStops || base.assigned != car.assignedPassengers
+            || base.inside != car.passengersInside || base.boarding != car.boardingPassengers) {
+            base = { now, maxStops, car.assignedPassengers, car.passengersInside, car.boardingPassengers,
+                Rollout(config, car, now, maxStops) };
+        }
+
+        int start = bank.StopFloor(car, startFloor);
+        bool hadRequest = work.requests[d].Test(start);
+        if (!hadRequest) work.first[d][start] = work.last[d][start] = 0;
+        work.extraFloor = start;
+        work.extraDirection = d;
+        work.extraTarget = bank.StopFloor(car, targetFloor);
+        work.requests[d].Set(start);
+        work.waiting++;
+        float cost = Rollout(config, car, now, maxStops) - base.cost;
+
+        if (best == -1 || cost < bestCost || (cost == bestCost && car.index < best)) {
+            best = car.index;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
+
+unique_ptr<Dispatcher> CreateDispatcher(const string& name) {
+    if (name == "nearest") return make_unique<NearestCarDispatcher>();
+    if (name == "eta") return make_unique<EtaDispatcher>();
+    if (name == "destination") return make_unique<DestinationDispatcher>();
+    return nullptr;
+}
@@ -0,0 +1,97 @@
+﻿#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Simulation.h"
+
+// Wybiera kabinę, która obsłuży nowe wezwanie z piętra startFloor. Brane są pod uwagę tylko kabiny,
+// które przewiozą pasażera wprost (ElevatorBank::Serves).
+class Dispatcher {
+public:
+    virtual ~Dispatcher() = default;
+    virtual int AssignCar(const ElevatorBank& bank, int startFloor, int targetFloor) = 0;
+    virtual const char* Name() const = 0;
+};
+
+// Najbliższa kabina, niezależnie od kierunku jazdy i obciążenia.
+class NearestCarDispatcher : public Dispatcher {
+public:
+    int AssignCar(const ElevatorBank& bank, int startFloor, int targetFloor) override;
+    const char* Name() const override { return "nearest"; }
+};
+
+// Kabina o najkrótszym szacowanym czasie dojazdu: droga z uwzględnieniem kierunku jazdy,
+// postoje dla już przydzielonych pasażerów i dodatkowy kurs, gdy kabina jest pełna.
+class EtaDispatcher : public Dispatcher {
+public:
+    int AssignCar(const ElevatorBank& bank, int startFloor, int targetFloor) override;
+    const char* Name() const override { return "eta"; }
+
+    static float EstimateArrival(const BuildingConfig& config, const Elevator& car, int startFloor, int targetFloor);
+};
+
+// Przydział według celu podróży (destination control). Dla każdej kabiny symuluje kolejne postoje
+// tak, jak wybrałby je automat kabiny (jazda w jednym kierunku, zawracanie, pojemność, ignorowanie wezwań
+// przy zapełnieniu), i liczy sumę przewidywanych czasów podróży jej pasażerów z nowym wezwaniem i bez niego.
+// Wybiera kabinę o najmniejszym przyroście kosztu, więc pasażerowie jadący na te same piętra trafiają
+// do tej samej kabiny, a nowy postój wydłuża podróż tych, którzy już jadą.
+class DestinationDispatcher : public Dispatcher {
+public:
+    // Ograniczenie pracy jednej decyzji. Symulowanych jest co najwyżej MAX_CANDIDATES kabin o najkrótszym
+    // czasie dojazdu według EtaDispatcher, a łączna liczba symulowanych postojów to STOP_BUDGET.
+    static constexpr int MAX_CANDIDATES = 8;
+    static constexpr int STOP_BUDGET = 512;
+    static constexpr int MAX_LOOKAHEAD_STOPS = 64;
+    // Z kolejki jednego piętra brane są cele co najwyżej tylu pierwszych zapełnień kabiny, więc przygotowanie
+    // kabiny kosztuje O(piętra × pojemność), a nie O(czekający).
+    static constexpr int MAX_QUEUE_LOADS = 4;
+
+    int AssignCar(const ElevatorBank& bank, int startFloor, int targetFloor) override;
+    const char* Name() const override { return "destination"; }
+
+private:
+    // Zadania kabiny: jadący (liczba na piętro docelowe) i czekający (piętra docelowe w kolejności kolejki,
+    // targets[first[d][piętro]] .. targets[last[d][piętro] - 1]), osobno w górę (0) i w dół (1).
+    // Nowe wezwanie (extraFloor != -1) jest doliczane na końcu swojej kolejki. Piętra z truncated mają
+    // w kolejce więcej osób niż zapisanych celów; pozostali (i nowy pasażer za nimi) czekają do końca horyzontu.
+    struct CarWork {
+        std::vector<int> ridersTo;
+        std::vector<int> targets;
+        std::vector<int> first[2];
+        std::vector<int> last[2];
+        FloorSet destinations;
+        FloorSet requests[2];
+        FloorSet truncated[2];
+        int inside = 0;
+        int waiting = 0;
+        int extraFloor = -1;
+        int extraDirection = 0;
+        int extraTarget = -1;
+    };
+    // Koszt kabiny bez nowego wezwania, ważny dopóki nie zmieni się czas, horyzont ani liczba jej pasażerów.
+    struct BaseCost {
+        uint32_t time = 0;
+        int maxStops = -1;
+        int assigned = -1;
+        int inside = -1;
+        int boarding = -1;
+        float cost = 0.0f;
+    };
+
+    void LoadWork(const ElevatorBank& bank, const Elevator& car);
+    float Rollout(const BuildingConfig& config, const Elevator& car, uint32_t now, int maxStops);
+    int NextStop(int floor, Direction& direction, bool full, bool inclusive) const;
+
+    CarWork work;
+    std::vector<BaseCost> baseCosts;
+    std::vector<std::pair<float, int>> candidates;
+    // Stan symulowanego kursu.
+    std::vector<int> ridersTo;
+    std::vector<int> cursor[2];
+    FloorSet destinations;
+    FloorSet requests[2];
+};
+
+std::unique_ptr<Dispatcher> CreateDispatcher(const std::string& name);
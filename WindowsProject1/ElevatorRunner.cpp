@@ -0,0 +1,355 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Digest.h"
+#include "Dispatcher.h"
+#include "EventLog.h"
+#include "EventScheduler.h"
+#include "Metrics.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "Trace.h"
+
+using namespace std;
+
+void GenerateArrivals(int count, uint32_t duration, unsigned seed, const BuildingConfig& config, vector<TraceRecord>& arrivals) {
+    mt19937 rng(seed);
+    uniform_int_distribution<uint32_t> timeDist(0, duration);
+    uniform_int_distribution<int> floorDist(0, config.floorCount - 1);
+    for (int i = 0; i < count; ++i) {
+        int start = floorDist(rng);
+        int target = floorDist(rng);
+        while (target == start) target = floorDist(rng);
+        arrivals.push_back({ timeDist(rng), (uint16_t)(config.GroundFloor() - start), (uint16_t)(config.GroundFloor() - target) });
+    }
+}
+
+void PrintUsage(const char* name) {
+    fprintf(stderr,
+        "Użycie: %s [plik_ruchu] [--random N] [--traffic poisson|up-peak|down-peak|lunch] [--rate N]\n"
+        "          [--duration MS] [--seed S] [--max-time MS] [--tick]\n"
+        "          [--cars N] [--dispatcher nearest|eta|destination] [--config plik] [--boarding aos|scalar|sse|avx2|auto]\n"
+        "          [--motion constant|jerk] [--parking ground|demand] [--metrics plik.csv] [--metrics-every MS]\n"
+        "          [--checkpoint-every MS] [--checkpoint-dir katalog] [--restore plik] [--save plik]\n"
+        "          [--digest plik.csv] [--digest-every MS] [--digest-after MS] [--event-log plik.bin] [--event-log-size N]\n"
+        "  plik_ruchu  plik binarny z elevator_tracegen albo CSV \"czas_ms,piętro_startowe,piętro_docelowe\" (0 = parter)\n"
+        "  --traffic   przyjścia generowane w trakcie symulacji, --rate na godzinę\n"
+        "  --tick      krok co TICK_DURATION zamiast symulacji zdarzeniowej\n"
+        "  --motion    jerk: jazda z ograniczoną prędkością, przyspieszeniem i zrywem, parametry w --config\n"
+        "              (floor_height_m, speed_m_s, acceleration_m_s2, jerk_m_s3)\n"
+        "  --parking   demand: wolna kabina czeka tam, skąd według wyuczonego popytu przyjdzie następne wezwanie,\n"
+        "              zamiast na parterze (demand_half_life_ms, demand_slot_ms w --config)\n"
+        "  --metrics   percentyle czasów i liczniki kabin co --metrics-every ms (domyślnie godzina) i na końcu\n"
+        "  --checkpoint-every  zapis stanu co MS ms do katalogu --checkpoint-dir jako checkpoint_<ms>.snap\n"
+        "  --restore   wznawia przebieg z pliku stanu (konfiguracja i dyspozytor z pliku, ruch z tych samych opcji)\n"
+        "  --save      zapisuje stan na końcu przebiegu (np. po --max-time)\n"
+        "  --digest    skrót przebiegu co --digest-every ms (domyślnie minuta), od chwili --digest-after;\n"
+        "              pierwszy różny wiersz dwóch plików wskazuje odcinek, w którym przebiegi się rozeszły\n"
+        "  --event-log dziennik zdarzeń kabin (ostatnie --event-log-size, domyślnie 1048576), do zamiany na JSON\n"
+        "              programem elevator_eventlog\n",
+        name);
+}
+
+bool WriteCheckpoint(const string& directory, const ElevatorBank& bank, const RunPosition& position) {
+    char name[64];
+    snprintf(name, sizeof(name), "checkpoint_%010u.snap", bank.clock.Now());
+    string error;
+    if (SaveSnapshot(directory + "/" + name, bank, position, error)) return true;
+    fprintf(stderr, "Błąd zapisu stanu: %s\n", error.c_str());
+    return false;
+}
+
+// Pierwsza wielokrotność interval po time albo 0, gdy interval == 0.
+uint32_t NextMultiple(uint32_t time, uint32_t interval) {
+    return interval ? (time / interval + 1) * interval : 0;
+}
+
+// Najwcześniejsza z niezerowych chwil albo 0, gdy wszystkie są zerowe.
+uint32_t EarliestPause(initializer_list<uint32_t> times) {
+    uint32_t earliest = 0;
+    for (uint32_t time : times) {
+        if (time && (!earliest || time < earliest)) earliest = time;
+    }
+    return earliest;
+}
+
+int main(int argc, char** argv) {
+    const char* tracePath = nullptr;
+    int randomCount = 0;
+    const char* trafficName = nullptr;
+    double rate = 600.0;
+    uint32_t duration = 24u * 60u * 60u * 1000u;
+    unsigned seed = 1;
+    uint32_t maxTime = 0;
+    bool fixedTick = false;
+    int carCount = 0;
+    const char* configPath = nullptr;
+    string dispatcherName = "nearest";
+    const char* boardingName = nullptr;
+    const char* motionName = nullptr;
+    const char* parkingName = nullptr;
+    const char* metricsPath = nullptr;
+    uint32_t metricsInterval = 60u * 60u * 1000u;
+    uint32_t checkpointInterval = 0;
+    string checkpointDir = ".";
+    const char* restorePath = nullptr;
+    const char* savePath = nullptr;
+    const char* digestPath = nullptr;
+    uint32_t digestInterval = 60u * 1000u;
+    uint32_t digestAfter = 0;
+    const char* eventLogPath = nullptr;
+    size_t eventLogSize = 1u << 20;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--random") && i + 1 < argc) randomCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--traffic") && i + 1 < argc) trafficName = argv[++i];
+        else if (!strcmp(argv[i], "--rate") && i + 1 < argc) rate = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--duration") && i + 1 < argc) duration = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--max-time") && i + 1 < argc) maxTime = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--tick")) fixedTick = true;
+        else if (!strcmp(argv[i], "--cars") && i + 1 < argc) carCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--dispatcher") && i + 1 < argc) dispatcherName = argv[++i];
+        else if (!strcmp(argv[i], "--config") && i + 1 < argc) configPath = argv[++i];
+        else if (!strcmp(argv[i], "--boarding") && i + 1 < argc) boardingName = argv[++i];
+        else if (!strcmp(argv[i], "--motion") && i + 1 < argc) motionName = argv[++i];
+        else if (!strcmp(argv[i], "--parking") && i + 1 < argc) parkingName = argv[++i];
+        else if (!strcmp(argv[i], "--metrics") && i + 1 < argc) metricsPath = argv[++i];
+        else if (!strcmp(argv[i], "--metrics-every") && i + 1 < argc) metricsInterval = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--checkpoint-every") && i + 1 < argc) checkpointInterval = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--checkpoint-dir") && i + 1 < argc) checkpointDir = argv[++i];
+        else if (!strcmp(argv[i], "--restore") && i + 1 < argc) restorePath = argv[++i];
+        else if (!strcmp(argv[i], "--save") && i + 1 < argc) savePath = argv[++i];
+        else if (!strcmp(argv[i], "--digest") && i + 1 < argc) digestPath = argv[++i];
+        else if (!strcmp(argv[i], "--digest-every") && i + 1 < argc) digestInterval = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--digest-after") && i + 1 < argc) digestAfter = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--event-log") && i + 1 < argc) eventLogPath = argv[++i];
+        else if (!strcmp(argv[i], "--event-log-size") && i + 1 < argc) eventLogSize = (size_t)strtoull(argv[++i], nullptr, 10);
+        else if (argv[i][0] != '-' && !tracePath) tracePath = argv[i];
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+#ifndef ELEVATOR_EVENT_LOG
+    if (eventLogPath) {
+        fprintf(stderr, "Dziennik zdarzeń wyłączony przy kompilacji (ELEVATOR_EVENT_LOG)\n");
+        return 1;
+    }
+#endif
+    if (eventLogPath) StartEventLog(eventLogSize);
+
+    BuildingConfig config;
+    string error;
+    ManualClock clock;
+    unique_ptr<ElevatorBank> bank;
+    RunPosition position;
+    if (restorePath) {
+        bank = LoadSnapshot(restorePath, clock, position, error);
+        if (!bank) {
+            fprintf(stderr, "Błąd pliku stanu: %s\n", error.c_str());
+            return 1;
+        }
+        config = bank->config;
+    }
+    else {
+        if (configPath && !LoadBuildingConfig(configPath, config, error)) {
+            fprintf(stderr, "Błąd konfiguracji: %s\n", error.c_str());
+            return 1;
+        }
+        if (carCount > 0) config.carCount = carCount;
+        if (boardingName && !ParseBoardingKernel(boardingName, config.boardingKernel)) {
+            fprintf(stderr, "Nieznany tryb wsiadania: %s\n", boardingName);
+            return 1;
+        }
+        if (motionName && !ParseMotionModel(motionName, config.motionModel)) {
+            fprintf(stderr, "Nieznany model ruchu: %s\n", motionName);
+            return 1;
+        }
+        if (parkingName && !ParseParkingPolicy(parkingName, config.parkingPolicy)) {
+            fprintf(stderr, "Nieznana polityka postoju: %s\n", parkingName);
+            return 1;
+        }
+        if (!ValidateBuildingConfig(config, error)) {
+            fprintf(stderr, "Błąd konfiguracji: %s\n", error.c_str());
+            return 1;
+        }
+    }
+
+    unique_ptr<TraceSource> source;
+    string traceError;
+    if (tracePath) {
+        source = OpenTrace(tracePath, traceError);
+        if (!source) {
+            fprintf(stderr, "Błąd pliku ruchu: %s\n", traceError.c_str());
+            return 1;
+        }
+    }
+    else if (trafficName) {
+        TrafficPattern pattern;
+        if (!ParseTrafficPattern(trafficName, pattern) || rate <= 0) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        source = make_unique<TrafficGenerator>(pattern, config.floorCount, rate, duration, seed);
+    }
+    else if (randomCount > 0) {
+        vector<TraceRecord> arrivals;
+        GenerateArrivals(randomCount, duration, seed, config, arrivals);
+        stable_sort(arrivals.begin(), arrivals.end(), [](const TraceRecord& a, const TraceRecord& b) { return a.time < b.time; });
+        source = make_unique<TraceBuffer>(move(arrivals));
+    }
+    else {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (!bank) {
+        unique_ptr<Dispatcher> dispatcher = CreateDispatcher(dispatcherName);
+        if (!dispatcher) {
+            fprintf(stderr, "Nieznany dyspozytor: %s\n", dispatcherName.c_str());
+            return 1;
+        }
+        bank = make_unique<ElevatorBank>(clock, config, move(dispatcher));
+    }
+
+    FILE* metricsOut = nullptr;
+    if (metricsPath) {
+        metricsOut = fopen(metricsPath, "w");
+        if (!metricsOut || metricsInterval == 0) {
+            fprintf(stderr, "Nie można zapisać metryk do %s\n", metricsPath);
+            return 1;
+        }
+        WriteMetricsHeader(metricsOut);
+    }
+    FILE* digestOut = nullptr;
+    if (digestPath) {
+        digestOut = fopen(digestPath, "w");
+        if (!digestOut || digestInterval == 0) {
+            fprintf(stderr, "Nie można zapisać skrótów do %s\n", digestPath);
+            return 1;
+        }
+        WriteDigestHeader(digestOut);
+    }
+    uint32_t nextReport = metricsOut ? NextMultiple(clock.Now(), metricsInterval) : 0;
+    uint32_t nextCheckpoint = NextMultiple(clock.Now(), checkpointInterval);
+    uint32_t nextDigest = 0;
+    if (digestOut) nextDigest = digestAfter > clock.Now() ? digestAfter : NextMultiple(clock.Now(), digestInterval);
+
+    auto wallStart = chrono::steady_clock::now();
+    uint64_t ticks = 0;
+    uint64_t skippedTicks = 0;
+    if (fixedTick) {
+        source->Skip(position.arrivalsTaken);
+        TraceRecord next;
+        bool hasNext = source->Next(next);
+        while (hasNext || bank->PassengersInSystem() > 0) {
+            if (maxTime && clock.Now() >= maxTime) break;
+            while (hasNext && next.time <= clock.Now()) {
+                bank->AddPassenger(config.FloorFromLabel(next.startFloor), config.FloorFromLabel(next.targetFloor), next.time);
+                position.arrivalsTaken++;
+                hasNext = source->Next(next);
+            }
+            clock.Advance(TICK_DURATION);
+            bank->MoveElevator();
+            ticks++;
+            if (nextReport && clock.Now() >= nextReport) {
+                WriteMetricsRow(metricsOut, clock.Now(), bank->metrics, config.CarCapacity());
+                nextReport += metricsInterval;
+            }
+            if (nextCheckpoint && clock.Now() >= nextCheckpoint) {
+                if (!WriteCheckpoint(checkpointDir, *bank, position)) return 1;
+                nextCheckpoint += checkpointInterval;
+            }
+            if (nextDigest && clock.Now() >= nextDigest) {
+                WriteDigestRow(digestOut, clock.Now(), bank->digest);
+                nextDigest += digestInterval;
+            }
+        }
+    }
+    else {
+        EventScheduler scheduler(*bank, clock);
+        if (restorePath) scheduler.Resume(position);
+        scheduler.SetArrivalSource(source.get());
+        // Przy zapisie metryk, stanu i skrótów symulacja biegnie odcinkami do kolejnych chwil raportu lub zapisu.
+        while (true) {
+            uint32_t pause = EarliestPause({ nextReport, nextCheckpoint, nextDigest });
+            if (!pause || (maxTime && pause >= maxTime)) break;
+            scheduler.Run(pause);
+            if (clock.Now() < pause) break;
+            if (nextReport && clock.Now() >= nextReport) {
+                WriteMetricsRow(metricsOut, clock.Now(), bank->metrics, config.CarCapacity());
+                nextReport += metricsInterval;
+            }
+            if (nextCheckpoint && clock.Now() >= nextCheckpoint) {
+                if (!WriteCheckpoint(checkpointDir, *bank, scheduler.Position())) return 1;
+                nextCheckpoint += checkpointInterval;
+            }
+            if (nextDigest && clock.Now() >= nextDigest) {
+                WriteDigestRow(digestOut, clock.Now(), bank->digest);
+                nextDigest += digestInterval;
+            }
+        }
+        scheduler.Run(maxTime);
+        ticks = scheduler.ProcessedTicks();
+        skippedTicks = scheduler.SkippedTicks();
+        position = scheduler.Position();
+    }
+    double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+    double simSeconds = clock.Now() / 1000.0;
+
+    printf("Przyjazdy:            %d\n", bank->nextPassengerId);
+    printf("Przewiezieni:         %d\n", bank->deliveredPassengers);
+    printf("Pozostali w systemie: %zu\n", bank->PassengersInSystem());
+    printf("Kabiny:               %zu (%s)\n", bank->cars.size(), bank->dispatcher->Name());
+    if (!config.zones.empty()) printf("Strefy:               %zu (przesiadki: %llu)\n", config.zones.size(), (unsigned long long)bank->transfers);
+    if (config.patience > 0 || config.balkQueue > 0 || config.stairsFloors > 0) {
+        printf("Zrezygnowali:         %llu w kolejce, %llu przy przyjściu\n", (unsigned long long)bank->reneged, (unsigned long long)bank->balked);
+        printf("Schodami:             %llu\n", (unsigned long long)bank->walked);
+    }
+    if (bank->metrics.wait.Count() > 0) printf("Średni czas czekania: %.1f s\n", bank->metrics.wait.Mean() / 1000.0);
+    printf("Kroki symulacji:      %llu\n", (unsigned long long)ticks);
+    if (!fixedTick) printf("Kroki pominięte:      %llu\n", (unsigned long long)skippedTicks);
+    printf("Czas symulowany:      %.1f s\n", simSeconds);
+    printf("Czas rzeczywisty:     %.3f s\n", wallSeconds);
+    if (wallSeconds > 0) printf("Przyspieszenie:       %.0fx\n", simSeconds / wallSeconds);
+    PrintMetricsSummary(stdout, bank->metrics, config.CarCapacity());
+    printf("Skrót przebiegu:      %016llx (%llu zdarzeń)\n", (unsigned long long)bank->digest.Value(), (unsigned long long)bank->digest.Events());
+
+    if (eventLogPath) {
+        StopEventLog();
+        if (!SaveEventLog(eventLogPath, error)) {
+            fprintf(stderr, "Błąd zapisu dziennika: %s\n", error.c_str());
+            return 1;
+        }
+    }
+    if (savePath && !SaveSnapshot(savePath, *bank, position, error)) {
+        fprintf(stderr, "Błąd zapisu stanu: %s\n", error.c_str());
+        return 1;
+    }
+    if (metricsOut) {
+        WriteMetricsRow(metricsOut, clock.Now(), bank->metrics, config.CarCapacity());
+        if (fclose(metricsOut) != 0) {
+            fprintf(stderr, "Nie można zapisać metryk do %s\n", metricsPath);
+            return 1;
+        }
+    }
+    if (digestOut) {
+        WriteDigestRow(digestOut, clock.Now(), bank->digest);
+        if (fclose(digestOut) != 0) {
+            fprintf(stderr, "Nie można zapisać skrótów do %s\n", digestPath);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+﻿#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Dispatcher.h"
+#include "EventScheduler.h"
+#include "Simulation.h"
+#include "Trace.h"
+
+using namespace std;
+
+namespace {
+
+const uint32_t DURATION = 30 * 60 * 1000;
+const uint32_t DIGEST_INTERVAL = 10 * 1000;
+const double RATE = 3000.0;
+
+struct Variant {
+    const char* name;
+    BuildingConfig config;
+};
+
+// Skróty przebiegu co DIGEST_INTERVAL ms i na końcu, tak jak w elevator_runner --digest.
+struct DigestRows {
+    vector<uint32_t> times;
+    vector<uint64_t> values;
+
+    void Add(uint32_t time, const StateDigest& digest) {
+        times.push_back(time);
+        values.push_back(digest.Value());
+    }
+};
+
+DigestRows RunTick(const BuildingConfig& config, const char* dispatcherName, TrafficPattern pattern) {
+    ManualClock clock;
+    ElevatorBank bank(clock, config, CreateDispatcher(dispatcherName));
+    TrafficGenerator source(pattern, config.floorCount, RATE, DURATION, 1);
+    DigestRows rows;
+    uint32_t nextDigest = DIGEST_INTERVAL;
+    TraceRecord next;
+    bool hasNext = source.Next(next);
+    while (hasNext || bank.PassengersInSystem() > 0) {
+        while (hasNext && next.time <= clock.Now()) {
+            bank.AddPassenger(config.FloorFromLabel(next.startFloor), config.FloorFromLabel(next.targetFloor), next.time);
+            hasNext = source.Next(next);
+        }
+        clock.Advance(TICK_DURATION);
+        bank.MoveElevator();
+        if (clock.Now() >= nextDigest) {
+            rows.Add(clock.Now(), bank.digest);
+            nextDigest += DIGEST_INTERVAL;
+        }
+    }
+    rows.Add(clock.Now(), bank.digest);
+    return rows;
+}
+
+DigestRows RunEvent(const BuildingConfig& config, const char* dispatcherName, TrafficPattern pattern) {
+    ManualClock clock;
+    ElevatorBank bank(clock, config, CreateDispatcher(dispatcherName));
+    TrafficGenerator source(pattern, config.floorCount, RATE, DURATION, 1);
+    EventScheduler scheduler(bank, clock);
+    scheduler.SetArrivalSource(&source);
+    DigestRows rows;
+    for (uint32_t pause = DIGEST_INTERVAL;; pause += DIGEST_INTERVAL) {
+        scheduler.Run(pause);
+        if (clock.Now() < pause) break;
+        rows.Add(clock.Now(), bank.digest);
+    }
+    rows.Add(clock.Now(), bank.digest);
+    return rows;
+}
+
+}
+
+// Sprawdza, że symulacja zdarzeniowa odtwarza pętlę krokową: ten sam ruch daje te same skróty przebiegu
+// dla każdego dyspozytora, także ze strefami, kabinami dwupokładowymi i zachowaniem pasażerów.
+// Kończy się kodem 1 i podaje chwilę pierwszej różnicy, gdy przebiegi się rozejdą.
+int main() {
+    vector<Variant> variants;
+    variants.push_back({ "zwykły", BuildingConfig() });
+    variants.back().config.floorCount = 20;
+    variants.back().config.carCount = 4;
+
+    variants.push_back({ "strefy", BuildingConfig() });
+    {
+        BuildingConfig& config = variants.back().config;
+        config.floorCount = 50;
+        config.carCount = 8;
+        string error;
+        SetBuildingConfigValue(config, "zone", "0-3 : 0-25 : double", error);
+        SetBuildingConfigValue(config, "zone", "4-7 : 0-1,26-49 : double", error);
+    }
+
+    variants.push_back({ "pasażerowie", BuildingConfig() });
+    {
+        BuildingConfig& config = variants.back().config;
+        config.floorCount = 30;
+        config.carCount = 6;
+        config.motionModel = MotionModel::JERK;
+        config.parkingPolicy = ParkingPolicy::DEMAND;
+        config.stairsFloors = 1;
+        config.balkQueue = 25;
+        config.patience = 60000;
+        config.walkSpeed = 2.0f;
+    }
+
+    const char* dispatchers[] = { "nearest", "eta", "destination" };
+    const TrafficPattern patterns[] = { TrafficPattern::UP_PEAK, TrafficPattern::LUNCH };
+
+    printf("%-12s %-12s %-8s %8s %s\n", "wariant", "dyspozytor", "ruch", "skróty", "wynik");
+    bool failed = false;
+    for (const auto& variant : variants) {
+        string error;
+        if (!ValidateBuildingConfig(variant.config, error)) {
+            fprintf(stderr, "Błąd konfiguracji %s: %s\n", variant.name, error.c_str());
+            return 1;
+        }
+        for (const char* dispatcher : dispatchers) {
+            for (TrafficPattern pattern : patterns) {
+                DigestRows tick = RunTick(variant.config, dispatcher, pattern);
+                DigestRows event = RunEvent(variant.config, dispatcher, pattern);
+                size_t row = 0;
+                while (row < tick.values.size() && row < event.values.size()
+                    && tick.times[row] == event.times[row] && tick.values[row] == event.values[row]) row++;
+                bool same = row == tick.values.size() && row == event.values.size();
+                char result[64];
+                if (same) snprintf(result, sizeof(result), "zgodne");
+                else if (row < tick.times.size()) snprintf(result, sizeof(result), "różne od %u ms", tick.times[row]);
+                else snprintf(result, sizeof(result), "różne na końcu");
+                printf("%-12s %-12s %-8s %8zu %s\n", variant.name, dispatcher, TrafficPatternName(pattern), tick.values.size(), result);
+                if (!same) failed = true;
+            }
+        }
+    }
+    if (failed) fprintf(stderr, "Symulacja zdarzeniowa różni się od pętli krokowej\n");
+    return failed ? 1 : 0;
+}
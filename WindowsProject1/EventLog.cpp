@@ -0,0 +1,314 @@
+﻿#include "EventLog.h"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+
+std::atomic<uint32_t> eventLogGeneration{ 0 };
+thread_local EventLogThread eventLogThread = { nullptr, 0 };
+
+// Bufory wszystkich wątków bieżącego dziennika. Dostęp pod blokadą tylko przy przydziale bufora wątkowi.
+static mutex ringsMutex;
+static vector<unique_ptr<EventRing>> rings;
+static uint32_t lastGeneration = 0;
+static size_t ringCapacity = 0;
+
+static const char LOG_MAGIC[8] = { 'E', 'L', 'V', 'L', 'O', 'G', '0', '1' };
+static const uint32_t LOG_VERSION = 1;
+static const size_t RECORD_SIZE = 16;
+
+const char* LogEventName(LogEvent event) {
+    switch (event) {
+    case LogEvent::RUN: return "run";
+    case LogEvent::ASSIGN: return "assign";
+    case LogEvent::DECIDE: return "decide";
+    case LogEvent::FULL: return "full";
+    case LogEvent::STATE: return "state";
+    case LogEvent::DIRECTION: return "direction";
+    case LogEvent::TARGET: return "target";
+    case LogEvent::BOARD: return "board";
+    case LogEvent::ALIGHT: return "alight";
+    case LogEvent::RENEGE: return "renege";
+    }
+    return "?";
+}
+
+EventRing::EventRing(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    records.resize(size);
+    mask = size - 1;
+}
+
+void EventRing::CopyTo(vector<LogRecord>& out) const {
+    uint64_t n = Written();
+    uint64_t kept = min<uint64_t>(n, records.size());
+    out.clear();
+    out.reserve((size_t)kept);
+    for (uint64_t i = n - kept; i < n; ++i) out.push_back(records[i & mask]);
+}
+
+void StartEventLog(size_t recordsPerThread) {
+    lock_guard<mutex> lock(ringsMutex);
+    rings.clear();
+    ringCapacity = max<size_t>(recordsPerThread, 1);
+    lastGeneration++;
+    eventLogGeneration.store(lastGeneration, memory_order_release);
+}
+
+void StopEventLog() {
+    eventLogGeneration.store(0, memory_order_release);
+}
+
+EventRing* AttachEventRing(uint32_t generation) {
+    lock_guard<mutex> lock(ringsMutex);
+    if (generation != lastGeneration) return nullptr;
+    rings.push_back(make_unique<EventRing>(ringCapacity));
+    eventLogThread.ring = rings.back().get();
+    eventLogThread.generation = generation;
+    return eventLogThread.ring;
+}
+
+static void PutU32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint32_t GetU32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void PutRecord(uint8_t* p, const LogRecord& record) {
+    PutU32(p, record.time);
+    p[4] = (uint8_t)record.type;
+    p[5] = record.reserved;
+    p[6] = (uint8_t)record.car;
+    p[7] = (uint8_t)(record.car >> 8);
+    PutU32(p + 8, (uint32_t)record.a);
+    PutU32(p + 12, (uint32_t)record.b);
+}
+
+static LogRecord GetRecord(const uint8_t* p) {
+    LogRecord record;
+    record.time = GetU32(p);
+    record.type = (LogEvent)p[4];
+    record.reserved = p[5];
+    record.car = (uint16_t)(p[6] | (p[7] << 8));
+    record.a = (int32_t)GetU32(p + 8);
+    record.b = (int32_t)GetU32(p + 12);
+    return record;
+}
+
+bool SaveEventLog(const string& path, string& error) {
+    lock_guard<mutex> lock(ringsMutex);
+    FILE* out = fopen(path.c_str(), "wb");
+    if (!out) {
+        error = "nie można zapisać pliku " + path;
+        return false;
+    }
+    uint8_t header[16];
+    memcpy(header, LOG_MAGIC, sizeof(LOG_MAGIC));
+    PutU32(header + 8, LOG_VERSION);
+    PutU32(header + 12, (uint32_t)rings.size());
+    fwrite(header, 1, sizeof(header), out);
+
+    vector<LogRecord> records;
+    vector<uint8_t> bytes;
+    for (size_t i = 0; i < rings.size(); ++i) {
+        uint64_t written = rings[i]->Written();
+        rings[i]->CopyTo(records);
+        uint8_t thread[16];
+        PutU32(thread, (uint32_t)i);
+        PutU32(thread + 4, (uint32_t)written);
+        PutU32(thread + 8, (uint32_t)(written >> 32));
+        PutU32(thread + 12, (uint32_t)records.size());
+        fwrite(thread, 1, sizeof(thread), out);
+        bytes.resize(records.size() * RECORD_SIZE);
+        for (size_t r = 0; r < records.size(); ++r) PutRecord(&bytes[r * RECORD_SIZE], records[r]);
+        fwrite(bytes.data(), 1, bytes.size(), out);
+    }
+    if (ferror(out) || fclose(out) != 0) {
+        error = "błąd zapisu pliku " + path;
+        return false;
+    }
+    return true;
+}
+
+bool LoadEventLog(const string& path, vector<LoggedThread>& threads, string& error) {
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) {
+        error = "nie można otworzyć pliku " + path;
+        return false;
+    }
+    unique_ptr<FILE, int (*)(FILE*)> closer(in, fclose);
+    uint8_t header[16];
+    if (fread(header, 1, sizeof(header), in) != sizeof(header) || memcmp(header, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0) {
+        error = path + " nie jest dziennikiem zdarzeń";
+        return false;
+    }
+    if (GetU32(header + 8) != LOG_VERSION) {
+        error = "nieobsługiwana wersja dziennika " + to_string(GetU32(header + 8));
+        return false;
+    }
+    threads.assign(GetU32(header + 12), LoggedThread());
+    vector<uint8_t> bytes;
+    for (auto& thread : threads) {
+        uint8_t info[16];
+        if (fread(info, 1, sizeof(info), in) != sizeof(info)) {
+            error = "niepełny plik " + path;
+            return false;
+        }
+        thread.thread = GetU32(info);
+        thread.written = GetU32(info + 4) | (uint64_t)GetU32(info + 8) << 32;
+        uint32_t count = GetU32(info + 12);
+        bytes.resize((size_t)count * RECORD_SIZE);
+        if (fread(bytes.data(), 1, bytes.size(), in) != bytes.size()) {
+            error = "niepełny plik " + path;
+            return false;
+        }
+        thread.records.resize(count);
+        for (uint32_t r = 0; r < count; ++r) thread.records[r] = GetRecord(&bytes[(size_t)r * RECORD_SIZE]);
+    }
+    return true;
+}
+
+// Nazwy jak w protokole scenariuszy (Scenario.cpp).
+static const char* StateName(int state) {
+    static const char* names[] = { "idle", "moving", "stopped" };
+    return state >= 0 && state < 3 ? names[state] : "?";
+}
+
+static const char* DirectionName(int direction) {
+    static const char* names[] = { "up", "down", "none" };
+    return direction >= 0 && direction < 3 ? names[direction] : "?";
+}
+
+// Zapis jednego procesu (symulacji) w formacie Chrome Trace Event. Czas w µs.
+class ChromeTraceWriter {
+public:
+    explicit ChromeTraceWriter(FILE* out) : out(out) {}
+
+    void Begin() { fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", out); }
+    void End() { fputs("\n]}\n", out); }
+
+    void StartRun(uint32_t thread, int run, int floors, int cars) {
+        FinishRun();
+        pid++;
+        floorCount = floors;
+        openState.assign(max(cars, 0), -1);
+        namedCars.assign(max(cars, 0), false);
+        char name[128];
+        if (run > 0) snprintf(name, sizeof(name), "wątek %u, symulacja %d (%d pięter, %d kabin)", thread, run, floors, cars);
+        else snprintf(name, sizeof(name), "wątek %u, początek nadpisany", thread);
+        Metadata("process_name", -1, name);
+    }
+
+    void Add(const LogRecord& record) {
+        int car = record.car;
+        if (car >= (int)openState.size()) {
+            openState.resize(car + 1, -1);
+            namedCars.resize(car + 1, false);
+        }
+        if (!namedCars[car]) {
+            char name[32];
+            snprintf(name, sizeof(name), "kabina %d", car);
+            Metadata("thread_name", car, name);
+            namedCars[car] = true;
+        }
+        lastTime = record.time;
+        char args[96];
+        switch (record.type) {
+        case LogEvent::STATE:
+            if (openState[car] != -1) Event("E", StateName(openState[car]), car, record.time, nullptr);
+            snprintf(args, sizeof(args), "\"floor\":%d", Label(record.a));
+            Event("B", StateName(record.b), car, record.time, args);
+            openState[car] = record.b;
+            return;
+        case LogEvent::DIRECTION:
+            snprintf(args, sizeof(args), "\"floor\":%d,\"direction\":\"%s\"", Label(record.a), DirectionName(record.b));
+            break;
+        case LogEvent::ASSIGN:
+            snprintf(args, sizeof(args), "\"from\":%d,\"to\":%d", Label(record.a), Label(record.b));
+            break;
+        case LogEvent::TARGET:
+            snprintf(args, sizeof(args), "\"from\":%d,\"to\":%d", Label(record.a), Label(record.b));
+            break;
+        case LogEvent::DECIDE:
+        case LogEvent::FULL:
+            snprintf(args, sizeof(args), "\"floor\":%d,\"inside\":%d", Label(record.a), record.b);
+            break;
+        case LogEvent::BOARD:
+        case LogEvent::ALIGHT:
+        case LogEvent::RENEGE:
+            snprintf(args, sizeof(args), "\"floor\":%d,\"passenger\":%d", Label(record.a), record.b);
+            break;
+        default:
+            snprintf(args, sizeof(args), "\"a\":%d,\"b\":%d", record.a, record.b);
+            break;
+        }
+        Event("i", LogEventName(record.type), car, record.time, args);
+    }
+
+    // Zamyka odcinki stanów w chwili ostatniego zdarzenia.
+    void FinishRun() {
+        for (size_t car = 0; car < openState.size(); ++car) {
+            if (openState[car] != -1) Event("E", StateName(openState[car]), (int)car, lastTime, nullptr);
+        }
+        openState.clear();
+    }
+
+private:
+    int Label(int floor) const { return floor < 0 || floorCount <= 0 ? floor : floorCount - 1 - floor; }
+
+    void Separator() {
+        if (!first) fputs(",\n", out);
+        first = false;
+    }
+
+    void Event(const char* phase, const char* name, int car, uint32_t time, const char* args) {
+        Separator();
+        fprintf(out, "{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%llu", name, phase, pid, car, (unsigned long long)time * 1000);
+        if (phase[0] == 'i') fputs(",\"s\":\"t\"", out);
+        if (args) fprintf(out, ",\"args\":{%s}", args);
+        fputc('}', out);
+    }
+
+    void Metadata(const char* kind, int car, const char* name) {
+        Separator();
+        fprintf(out, "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d", kind, pid);
+        if (car >= 0) fprintf(out, ",\"tid\":%d", car);
+        fprintf(out, ",\"args\":{\"name\":\"%s\"}}", name);
+    }
+
+    FILE* out;
+    bool first = true;
+    int pid = 0;
+    int floorCount = 0;
+    uint32_t lastTime = 0;
+    vector<int> openState;
+    vector<bool> namedCars;
+};
+
+void WriteChromeTrace(FILE* out, const vector<LoggedThread>& threads) {
+    ChromeTraceWriter writer(out);
+    writer.Begin();
+    for (const auto& thread : threads) {
+        int run = 0;
+        bool started = false;
+        for (const auto& record : thread.records) {
+            if (record.type == LogEvent::RUN) {
+                writer.StartRun(thread.thread, ++run, record.a, record.b);
+                started = true;
+                continue;
+            }
+            if (!started) {
+                writer.StartRun(thread.thread, 0, 0, 0);
+                started = true;
+            }
+            writer.Add(record);
+        }
+        writer.FinishRun();
+    }
+    writer.End();
+}
@@ -0,0 +1,99 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Dziennik zdarzeń symulacji do szukania przyczyn decyzji kabin (np. dlaczego minęła piętro). Każdy wątek pisze
+// do własnego bufora cyklicznego bez blokad, a po jego zapełnieniu najstarsze rekordy są nadpisywane, więc dziennik
+// może zostać włączony na cały długi przebieg. Punkty LOG_EVENT w symulacji istnieją tylko przy ELEVATOR_EVENT_LOG
+// (opcja CMake); bez StartEventLog kosztują jeden odczyt i skok.
+enum class LogEvent : uint8_t {
+    RUN,        // nowa symulacja: a = liczba pięter, b = liczba kabin
+    ASSIGN,     // wezwanie przydzielone kabinie: a = piętro startowe, b = docelowe
+    DECIDE,     // wejście DecideNextMove: a = piętro kabiny, b = osoby w kabinie
+    FULL,       // DecideNextMove pomija wezwania, bo kabina jest pełna: a = piętro, b = osoby w kabinie
+    STATE,      // nowy stan kabiny (ElevatorState): a = piętro, b = stan
+    DIRECTION,  // nowy kierunek (Direction): a = piętro, b = kierunek
+    TARGET,     // nowy cel: a = poprzedni, b = nowy (-1 = brak)
+    BOARD,      // a = piętro, b = numer pasażera
+    ALIGHT,     // a = piętro, b = numer pasażera
+    RENEGE      // pasażer odszedł z kolejki po config.patience: a = piętro, b = numer pasażera
+};
+
+const char* LogEventName(LogEvent event);
+
+// Czas symulacji w ms; piętra to indeksy jak w ElevatorBank (0 = najwyższe).
+struct LogRecord {
+    uint32_t time;
+    LogEvent type;
+    uint8_t reserved;
+    uint16_t car;
+    int32_t a;
+    int32_t b;
+};
+
+// Bufor jednego wątku. Pisze tylko właściciel; rekord numer n leży pod n & mask.
+class EventRing {
+public:
+    // Pojemność jest zaokrąglana w górę do potęgi dwójki.
+    explicit EventRing(size_t capacity);
+
+    void Push(const LogRecord& record) {
+        uint64_t n = written.load(std::memory_order_relaxed);
+        records[n & mask] = record;
+        written.store(n + 1, std::memory_order_release);
+    }
+    uint64_t Written() const { return written.load(std::memory_order_acquire); }
+    // Zachowane rekordy od najstarszego.
+    void CopyTo(std::vector<LogRecord>& out) const;
+
+private:
+    std::vector<LogRecord> records;
+    size_t mask;
+    std::atomic<uint64_t> written{ 0 };
+};
+
+// Start, Stop i Save wywołuje się, gdy żaden wątek nie symuluje. Start zwalnia bufory poprzedniego dziennika;
+// wątki dostają nowe bufory przy pierwszym zdarzeniu.
+void StartEventLog(size_t recordsPerThread);
+void StopEventLog();
+// Plik: "ELVLOG01", wersja, liczba wątków, a dla każdego wątku numer, liczba wszystkich zdarzeń, liczba
+// zachowanych i rekordy po 16 bajtów little-endian.
+bool SaveEventLog(const std::string& path, std::string& error);
+
+struct LoggedThread {
+    uint32_t thread = 0;
+    uint64_t written = 0;
+    std::vector<LogRecord> records;
+};
+
+bool LoadEventLog(const std::string& path, std::vector<LoggedThread>& threads, std::string& error);
+// Format JSON Chrome Trace Event (chrome://tracing, ui.perfetto.dev): każda symulacja to proces, każda kabina
+// wątek z odcinkami stanów i zdarzeniami chwilowymi. Piętra jako etykiety (0 = parter).
+void WriteChromeTrace(FILE* out, const std::vector<LoggedThread>& threads);
+
+// Ścieżka szybka RecordEvent: numer bieżącego dziennika (0 = wyłączony) i bufor wątku z numerem, dla którego
+// został przydzielony.
+struct EventLogThread {
+    EventRing* ring;
+    uint32_t generation;
+};
+extern std::atomic<uint32_t> eventLogGeneration;
+extern thread_local EventLogThread eventLogThread;
+EventRing* AttachEventRing(uint32_t generation);
+
+inline void RecordEvent(LogEvent type, uint32_t time, int car, int a, int b) {
+    uint32_t generation = eventLogGeneration.load(std::memory_order_relaxed);
+    if (!generation) return;
+    EventRing* ring = eventLogThread.generation == generation ? eventLogThread.ring : AttachEventRing(generation);
+    if (ring) ring->Push({ time, type, 0, (uint16_t)car, a, b });
+}
+
+#ifdef ELEVATOR_EVENT_LOG
+#define LOG_EVENT(type, time, car, a, b) RecordEvent(LogEvent::type, time, car, a, b)
+#else
+#define LOG_EVENT(type, time, car, a, b) ((void)0)
+#endif
@@ -0,0 +1,42 @@
+﻿#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "EventLog.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr,
+            "Użycie: %s dziennik.bin [trace.json]\n"
+            "  Zamienia dziennik zdarzeń z elevator_runner --event-log na JSON dla chrome://tracing i ui.perfetto.dev\n"
+            "  (bez drugiego argumentu na standardowe wyjście).\n",
+            argv[0]);
+        return 1;
+    }
+    vector<LoggedThread> threads;
+    string error;
+    if (!LoadEventLog(argv[1], threads, error)) {
+        fprintf(stderr, "Błąd dziennika: %s\n", error.c_str());
+        return 1;
+    }
+    FILE* out = argc == 3 ? fopen(argv[2], "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Nie można zapisać %s\n", argv[2]);
+        return 1;
+    }
+    WriteChromeTrace(out, threads);
+    size_t kept = 0;
+    uint64_t written = 0;
+    for (const auto& thread : threads) {
+        kept += thread.records.size();
+        written += thread.written;
+    }
+    fprintf(stderr, "Wątki: %zu, zdarzenia: %zu (nadpisane: %llu)\n", threads.size(), kept, (unsigned long long)(written - kept));
+    if (out != stdout && fclose(out) != 0) {
+        fprintf(stderr, "Nie można zapisać %s\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}
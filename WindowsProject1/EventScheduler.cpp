@@ -0,0 +1,250 @@
+﻿#include "EventScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+uint32_t FirstTickAfter(uint32_t time) {
+    return (time / TICK_DURATION + 1) * TICK_DURATION;
+}
+
+EventScheduler::EventScheduler(ElevatorBank& bank, ManualClock& clock)
+    : bank(bank), clock(clock), changed(bank.cars.size(), false) {
+    // Przy przyjściach ze strumienia w kolejce jest kilka zdarzeń, więc krok nie powiększa jej pamięci.
+    vector<Event> storage;
+    storage.reserve(EVENT_RESERVE);
+    events = priority_queue<Event, vector<Event>, EventLater>(EventLater(), move(storage));
+    before.reserve(bank.cars.size());
+    ScheduleStateEvent();
+}
+
+void EventScheduler::ScheduleArrival(uint32_t time, int startFloor, int targetFloor, int count) {
+    PushArrival(time, startFloor, targetFloor, false, count);
+}
+
+void EventScheduler::PushArrival(uint32_t time, int startFloor, int targetFloor, bool streamed, int count) {
+    // Pętla krokowa dodaje pasażera przed pierwszym krokiem, w którym zegar przed krokiem >= time.
+    uint32_t tick = ((time + TICK_DURATION - 1) / TICK_DURATION + 1) * TICK_DURATION;
+    events.push({ tick, EventType::ARRIVAL, nextOrder++, startFloor, targetFloor, time, streamed, count });
+    pendingArrivals++;
+}
+
+void EventScheduler::SetArrivalSource(TraceSource* source) {
+    arrivalSource = source;
+    if (arrivalSource) arrivalSource->Skip(arrivalsTaken);
+    PullArrival();
+}
+
+RunPosition EventScheduler::Position() const {
+    RunPosition position;
+    position.arrivalsTaken = arrivalsTaken;
+    for (bool c : changed) position.changedCars.push_back(c ? 1 : 0);
+    return position;
+}
+
+// Kolejka zdarzeń nie jest zapisywana: następne zdarzenie stanu wynika ze stanu kabin i flag changed,
+// a przyjście ze strumienia jest pobierane ponownie.
+void EventScheduler::Resume(const RunPosition& position) {
+    arrivalsTaken = position.arrivalsTaken;
+    for (size_t i = 0; i < changed.size() && i < position.changedCars.size(); ++i) changed[i] = position.changedCars[i] != 0;
+    ScheduleStateEvent();
+}
+
+void EventScheduler::PullArrival() {
+    TraceRecord record;
+    if (!arrivalSource || !arrivalSource->Next(record)) return;
+    const BuildingConfig& config = bank.config;
+    PushArrival(record.time, config.FloorFromLabel(record.startFloor), config.FloorFromLabel(record.targetFloor), true);
+}
+
+void EventScheduler::AddArrival(const Event& event) {
+    bank.AddPassengers(event.startFloor, event.targetFloor, event.count, event.arrivalTime);
+    pendingArrivals--;
+    if (event.streamed) {
+        arrivalsTaken++;
+        PullArrival();
+    }
+}
+
+void EventScheduler::PushStateEvent(uint32_t time, EventType type) {
+    stateEventOrder = nextOrder++;
+    events.push({ time, type, stateEventOrder });
+}
+
+bool EventScheduler::PeekNext(Event& event) {
+    while (!events.empty()) {
+        const Event& top = events.top();
+        if (top.type == EventType::ARRIVAL || top.order == stateEventOrder) {
+            event = top;
+            return true;
+        }
+        events.pop();
+    }
+    return false;
+}
+
+bool EventScheduler::NextCarEvent(const Elevator& car, bool stateChanged, uint32_t& time, EventType& type) const {
+    const BuildingConfig& config = bank.config;
+    uint32_t next = clock.Now() + TICK_DURATION;
+
+    switch (car.currentState) {
+    case ElevatorState::IDLE:
+        if (bank.HasWaitingPassengers(car)) {
+            time = next;
+            type = EventType::TICK;
+            return true;
+        }
+        if (bank.ParkingFloor(car) != config.GetFloorFromY(car.elevatorY)) {
+            time = max(next, FirstTickAfter(car.stateTimer + config.idleReturnDelay));
+            type = EventType::IDLE_TIMEOUT;
+            return true;
+        }
+        // Piętro postoju zmienia się poza wezwaniami i zmianami stanu kabin tylko z porą dnia.
+        if (config.parkingPolicy == ParkingPolicy::DEMAND) {
+            uint32_t slotEnd = bank.demand.SlotEnd(clock.Now());
+            time = max({ next, FirstTickAfter(car.stateTimer + config.idleReturnDelay), (slotEnd + TICK_DURATION - 1) / TICK_DURATION * TICK_DURATION });
+            type = EventType::IDLE_TIMEOUT;
+            return true;
+        }
+        return false;
+
+    case ElevatorState::STOPPED:
+        time = max(next, FirstTickAfter(car.stateTimer + config.doorOpenDuration));
+        type = EventType::DOOR_CLOSE;
+        return true;
+
+    case ElevatorState::MOVING: {
+        if (car.targetFloor == -1 || stateChanged) {
+            time = next;
+            type = EventType::TICK;
+            return true;
+        }
+        // W modelu JERK pięter, na których kabina zdąży stanąć, z czasem tylko ubywa. Jeśli w kroku po
+        // wezwaniu cel się nie zmienił, zmieni go dopiero następne wezwanie, więc kolejnym zdarzeniem jest postój.
+        if (config.motionModel == MotionModel::JERK) {
+            uint32_t end = car.tripStart + car.tripDuration;
+            time = max(next, (end + TICK_DURATION - 1) / TICK_DURATION * TICK_DURATION);
+            type = EventType::FLOOR_REACHED;
+            return true;
+        }
+        // Zmiana celu w MoveElevator zależy tylko od piętra, więc wystarczy obudzić się przy
+        // przejściu na kolejne piętro albo przy dojeździe do celu.
+        bool canRetarget = car.currentDirection == Direction::DOWN && car.targetFloor == car.homeFloor;
+        float targetY = (float)car.targetFloor * config.floorHeight;
+        float y = car.elevatorY;
+        int startFloor = config.GetFloorFromY(y);
+        time = next;
+        while (true) {
+            if (abs(y - targetY) < config.elevatorSpeed) break;
+            if (y > targetY) y -= config.elevatorSpeed;
+            else y += config.elevatorSpeed;
+            if (canRetarget && config.GetFloorFromY(y) != startFloor) break;
+            time += TICK_DURATION;
+        }
+        type = EventType::FLOOR_REACHED;
+        return true;
+    }
+    }
+    return false;
+}
+
+void EventScheduler::ScheduleStateEvent() {
+    stateEventOrder = UINT64_MAX;
+
+    if (bank.HasBoardingPassengers()) {
+        PushStateEvent(clock.Now() + TICK_DURATION, EventType::TICK);
+        return;
+    }
+
+    bool found = false;
+    uint32_t earliest = 0;
+    EventType earliestType = EventType::TICK;
+    for (const auto& car : bank.cars) {
+        uint32_t time;
+        EventType type;
+        if (NextCarEvent(car, changed[car.index], time, type) && (!found || time < earliest)) {
+            found = true;
+            earliest = time;
+            earliestType = type;
+        }
+    }
+    // Czekający odchodzi w pierwszym kroku po swoim terminie, tak jak w pętli krokowej.
+    uint32_t deadline;
+    if (bank.NextPatienceDeadline(deadline)) {
+        uint32_t time = max(clock.Now() + TICK_DURATION, FirstTickAfter(deadline));
+        if (!found || time < earliest) {
+            found = true;
+            earliest = time;
+            earliestType = EventType::PATIENCE;
+        }
+    }
+    if (found) PushStateEvent(earliest, earliestType);
+}
+
+bool EventScheduler::Step() {
+    Event event;
+    if (!PeekNext(event)) return false;
+    events.pop();
+
+    uint32_t now = clock.Now();
+    uint32_t time = max(event.time, now + TICK_DURATION);
+    uint32_t skipped = (time - now) / TICK_DURATION - 1;
+    bank.FastForward(skipped);
+    skippedTicks += skipped;
+
+    // Pętla krokowa dodaje pasażerów przed przesunięciem zegara, więc dyspozytor widzi zegar z chwili,
+    // do której kabiny już dojechały (np. czas otwarcia drzwi w DestinationDispatcher).
+    clock.Set(time - TICK_DURATION);
+    if (event.type == EventType::ARRIVAL) AddArrival(event);
+    while (!events.empty() && events.top().time <= time) {
+        Event same = events.top();
+        events.pop();
+        if (same.type == EventType::ARRIVAL) AddArrival(same);
+    }
+    clock.Set(time);
+
+    before.clear();
+    for (const auto& car : bank.cars) before.push_back({ car.currentState, car.currentDirection, car.targetFloor });
+    uint64_t transfers = bank.transfers;
+    uint64_t reneged = bank.reneged;
+    bank.MoveElevator();
+    processedTicks++;
+
+    // Przesiadka w kroku to nowe wezwanie, które kabina przejrzana wcześniej w tym kroku zobaczy dopiero
+    // w następnym, a odejście czekającego zmienia wezwania kabiny bez zmiany jej stanu, więc wtedy
+    // wszystkie kabiny są traktowane jak zmienione.
+    bool callsChanged = bank.transfers != transfers || bank.reneged != reneged;
+    for (const auto& car : bank.cars) {
+        const CarSnapshot& b = before[car.index];
+        changed[car.index] = callsChanged || b.state != car.currentState || b.direction != car.currentDirection || b.targetFloor != car.targetFloor;
+    }
+    ScheduleStateEvent();
+    return true;
+}
+
+void EventScheduler::Run(uint32_t maxTime) {
+    Event event;
+    while ((pendingArrivals > 0 || bank.PassengersInSystem() > 0) && PeekNext(event)) {
+        if (maxTime && max(event.time, clock.Now() + TICK_DURATION) - TICK_DURATION >= maxTime) {
+            uint32_t end = max(clock.Now(), (maxTime + TICK_DURATION - 1) / TICK_DURATION * TICK_DURATION);
+            uint32_t skipped = (end - clock.Now()) / TICK_DURATION;
+            bank.FastForward(skipped);
+            skippedTicks += skipped;
+            clock.Set(end);
+            return;
+        }
+        Step();
+    }
+}
+
+// Kroki bez zdarzeń do końca przedziału są pomijane tak jak w Step.
+void EventScheduler::AdvanceTo(uint32_t time) {
+    Event event;
+    while (PeekNext(event) && max(event.time, clock.Now() + TICK_DURATION) <= time) Step();
+    if (time < clock.Now() + TICK_DURATION) return;
+    uint32_t skipped = (time - clock.Now()) / TICK_DURATION;
+    bank.FastForward(skipped);
+    skippedTicks += skipped;
+    clock.Set(clock.Now() + skipped * TICK_DURATION);
+}
@@ -0,0 +1,93 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "Trace.h"
+
+enum class EventType {
+    ARRIVAL,
+    DOOR_CLOSE,
+    IDLE_TIMEOUT,
+    FLOOR_REACHED,
+    PATIENCE,
+    TICK
+};
+
+struct Event {
+    uint32_t time;
+    EventType type;
+    uint64_t order;
+    int startFloor = -1;
+    int targetFloor = -1;
+    uint32_t arrivalTime = 0;
+    bool streamed = false;
+    int count = 1;
+};
+
+struct EventLater {
+    bool operator()(const Event& a, const Event& b) const {
+        if (a.time != b.time) return a.time > b.time;
+        return a.order > b.order;
+    }
+};
+
+// Symulacja zdarzeniowa. Czas przeskakuje od razu do kroku, w którym coś się zmienia,
+// a kroki pośrednie są pomijane. Wynik jest taki sam jak przy wywoływaniu MoveElevator co TICK_DURATION.
+class EventScheduler {
+public:
+    static const size_t EVENT_RESERVE = 64;
+
+    EventScheduler(ElevatorBank& bank, ManualClock& clock);
+
+    // count > 1 to grupa z jednego wezwania (ElevatorBank::AddPassengers).
+    void ScheduleArrival(uint32_t time, int startFloor, int targetFloor, int count = 1);
+    // Przyjścia są pobierane ze strumienia po jednym, więc w kolejce jest zawsze najwyżej jedno z nich.
+    // Po Resume rekordy już dodane do symulacji są najpierw pomijane.
+    void SetArrivalSource(TraceSource* source);
+    // Stan harmonogramu do zapisu razem z zespołem wind i jego odtworzenie (przed SetArrivalSource).
+    RunPosition Position() const;
+    void Resume(const RunPosition& position);
+    bool Step();
+    void Run(uint32_t maxTime = 0);
+    // Wykonuje wszystkie kroki do chwili time (zaokrąglonej w dół do kroku) włącznie, także gdy w budynku
+    // nikogo nie ma, i zostawia zegar w tej chwili.
+    void AdvanceTo(uint32_t time);
+    bool HasPendingArrivals() const { return pendingArrivals > 0; }
+
+    uint64_t ProcessedTicks() const { return processedTicks; }
+    uint64_t SkippedTicks() const { return skippedTicks; }
+
+private:
+    struct CarSnapshot {
+        ElevatorState state;
+        Direction direction;
+        int targetFloor;
+    };
+
+    bool PeekNext(Event& event);
+    void ScheduleStateEvent();
+    bool NextCarEvent(const Elevator& car, bool stateChanged, uint32_t& time, EventType& type) const;
+    void PushStateEvent(uint32_t time, EventType type);
+    void PushArrival(uint32_t time, int startFloor, int targetFloor, bool streamed, int count = 1);
+    void PullArrival();
+    void AddArrival(const Event& event);
+
+    ElevatorBank& bank;
+    ManualClock& clock;
+    TraceSource* arrivalSource = nullptr;
+    std::priority_queue<Event, std::vector<Event>, EventLater> events;
+    uint64_t nextOrder = 0;
+    uint64_t pendingArrivals = 0;
+    uint64_t arrivalsTaken = 0;
+    uint64_t stateEventOrder = UINT64_MAX;
+    uint64_t processedTicks = 0;
+    uint64_t skippedTicks = 0;
+    std::vector<CarSnapshot> before;
+    std::vector<bool> changed;
+};
+
+uint32_t FirstTickAfter(uint32_t time);
@@ -0,0 +1,148 @@
+﻿#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline int LowestBit(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (int)index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+inline int HighestBit(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, word);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(word);
+#endif
+}
+
+// Zbiór pięter jako maska bitowa. Wyszukiwanie najbliższego piętra kosztuje O(pięter / 64).
+class FloorSet {
+public:
+    void Resize(int floorCount) { words.assign((floorCount + 63) / 64, 0); }
+
+    void Set(int floor) { words[floor >> 6] |= 1ull << (floor & 63); }
+    void Reset(int floor) { words[floor >> 6] &= ~(1ull << (floor & 63)); }
+    bool Test(int floor) const { return (words[floor >> 6] >> (floor & 63)) & 1; }
+
+    bool Empty() const {
+        for (uint64_t w : words) if (w) return false;
+        return true;
+    }
+
+    // Najmniejsze piętro >= floor albo -1.
+    int FirstFrom(int floor) const {
+        if (floor < 0) floor = 0;
+        size_t i = floor >> 6;
+        if (i >= words.size()) return -1;
+        uint64_t w = words[i] & (~0ull << (floor & 63));
+        while (true) {
+            if (w) return (int)(i * 64) + LowestBit(w);
+            if (++i >= words.size()) return -1;
+            w = words[i];
+        }
+    }
+
+    // Największe piętro <= floor albo -1.
+    int LastUpTo(int floor) const {
+        if (floor < 0) return -1;
+        size_t i = floor >> 6;
+        if (i >= words.size()) {
+            i = words.size() - 1;
+            floor = (int)(i * 64) + 63;
+        }
+        uint64_t w = words[i] & (~0ull >> (63 - (floor & 63)));
+        while (true) {
+            if (w) return (int)(i * 64) + HighestBit(w);
+            if (i-- == 0) return -1;
+            w = words[i];
+        }
+    }
+
+    // Najbliższe piętro, przy równej odległości niższy numer. -1 gdy zbiór jest pusty.
+    int Nearest(int floor) const {
+        int below = LastUpTo(floor);
+        int above = FirstFrom(floor);
+        if (below == -1) return above;
+        if (above == -1) return below;
+        return (floor - below <= above - floor) ? below : above;
+    }
+
+private:
+    std::vector<uint64_t> words;
+};
+
+// Zbiór pięter budynku o liczbie pięter znanej przy kompilacji (do 64). Maska mieści się w jednym słowie,
+// więc wyszukiwanie to kilka instrukcji bez pętli.
+template <int Floors>
+class FixedFloorSet {
+    static_assert(Floors > 0 && Floors <= 64, "FixedFloorSet obsługuje do 64 pięter");
+
+public:
+    void Resize(int) { bits.reset(); }
+
+    void Set(int floor) { bits[floor] = true; }
+    void Reset(int floor) { bits[floor] = false; }
+    bool Test(int floor) const { return bits[floor]; }
+    bool Empty() const { return bits.none(); }
+
+    int FirstFrom(int floor) const {
+        if (floor < 0) floor = 0;
+        if (floor >= Floors) return -1;
+        uint64_t w = Word() & (~0ull << floor);
+        return w ? LowestBit(w) : -1;
+    }
+
+    int LastUpTo(int floor) const {
+        if (floor < 0) return -1;
+        if (floor >= Floors) floor = Floors - 1;
+        uint64_t w = Word() & (~0ull >> (63 - floor));
+        return w ? HighestBit(w) : -1;
+    }
+
+    int Nearest(int floor) const {
+        int below = LastUpTo(floor);
+        int above = FirstFrom(floor);
+        if (below == -1) return above;
+        if (above == -1) return below;
+        return (floor - below <= above - floor) ? below : above;
+    }
+
+private:
+    uint64_t Word() const { return (uint64_t)bits.to_ullong(); }
+
+    std::bitset<Floors> bits;
+};
+
+// Liczba zgłoszeń na każdym piętrze razem z maską pięter, na których jest co najmniej jedno.
+template <class Mask>
+struct BasicFloorRequests {
+    std::vector<int> count;
+    Mask floors;
+
+    void Resize(int floorCount) {
+        count.assign(floorCount, 0);
+        floors.Resize(floorCount);
+    }
+    void Add(int floor, int n = 1) {
+        if (count[floor] == 0) floors.Set(floor);
+        count[floor] += n;
+    }
+    void Remove(int floor) {
+        if (--count[floor] == 0) floors.Reset(floor);
+    }
+};
+
+typedef BasicFloorRequests<FloorSet> FloorRequests;
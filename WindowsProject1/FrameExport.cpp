@@ -0,0 +1,308 @@
+﻿#include "FrameExport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "SoftwareRenderer.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+const char* FrameFormatName(FrameFormat format) {
+    switch (format) {
+    case FrameFormat::PPM: return "ppm";
+    case FrameFormat::RGBA: return "rgba";
+    case FrameFormat::QOI: return "qoi";
+    }
+    return "?";
+}
+
+bool ParseFrameFormat(const string& name, FrameFormat& format) {
+    for (FrameFormat f : { FrameFormat::PPM, FrameFormat::RGBA, FrameFormat::QOI }) {
+        if (name == FrameFormatName(f)) {
+            format = f;
+            return true;
+        }
+    }
+    return false;
+}
+
+int FrameWidthForCars(int carCount) {
+    const int FRAME_MARGIN_X = 200;
+    return GetWallEndX(carCount) + FRAME_MARGIN_X;
+}
+
+bool CarsFitFrame(const ExportOptions& options, int carCount, string& error) {
+    for (int i = 0; i < carCount; ++i) {
+        int left = GetElevatorScreenX(i) - 2, right = GetElevatorScreenX(i) + ELEVATOR_WIDTH + 2;
+        if (left < 0 || right > options.width) {
+            error = "kabina " + to_string(i) + " nie mieści się w klatce o szerokości " + to_string(options.width)
+                + " (potrzeba co najmniej " + to_string(FrameWidthForCars(carCount)) + ")";
+            return false;
+        }
+    }
+    return true;
+}
+
+static void PutBigEndian(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(value >> (24 - 8 * i));
+}
+
+// Format QOI (qoiformat.org): piksel jest kodowany jako powtórzenie poprzedniego, odwołanie do tablicy 64 ostatnio
+// widzianych kolorów, mała różnica względem poprzedniego albo pełny kolor.
+static void EncodeQoi(const Argb* pixels, int width, int height, vector<uint8_t>& out) {
+    const uint8_t OP_INDEX = 0x00, OP_DIFF = 0x40, OP_LUMA = 0x80, OP_RUN = 0xC0, OP_RGB = 0xFE, OP_RGBA = 0xFF;
+    size_t count = (size_t)width * height;
+    // Najgorszy przypadek: każdy piksel jako OP_RGBA.
+    out.resize(14 + count * 5 + 8);
+    uint8_t* p = out.data();
+    memcpy(p, "qoif", 4);
+    PutBigEndian(p + 4, (uint32_t)width);
+    PutBigEndian(p + 8, (uint32_t)height);
+    p[12] = 4;
+    p[13] = 0;
+    p += 14;
+
+    Argb index[64] = {};
+    Argb previous = 0xFF000000u;
+    int run = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Argb c = pixels[i];
+        if (c == previous) {
+            if (++run == 62 || i + 1 == count) {
+                *p++ = (uint8_t)(OP_RUN | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            *p++ = (uint8_t)(OP_RUN | (run - 1));
+            run = 0;
+        }
+        int r = (c >> 16) & 0xFF, g = (c >> 8) & 0xFF, b = c & 0xFF, a = c >> 24;
+        int hash = (r * 3 + g * 5 + b * 7 + a * 11) % 64;
+        if (index[hash] == c) {
+            *p++ = (uint8_t)(OP_INDEX | hash);
+        }
+        else {
+            index[hash] = c;
+            if (a == (int)(previous >> 24)) {
+                int dr = (int8_t)(r - (int)((previous >> 16) & 0xFF));
+                int dg = (int8_t)(g - (int)((previous >> 8) & 0xFF));
+                int db = (int8_t)(b - (int)(previous & 0xFF));
+                int drg = dr - dg, dbg = db - dg;
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    *p++ = (uint8_t)(OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                }
+                else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                    *p++ = (uint8_t)(OP_LUMA | (dg + 32));
+                    *p++ = (uint8_t)((drg + 8) << 4 | (dbg + 8));
+                }
+                else {
+                    *p++ = OP_RGB;
+                    *p++ = (uint8_t)r;
+                    *p++ = (uint8_t)g;
+                    *p++ = (uint8_t)b;
+                }
+            }
+            else {
+                *p++ = OP_RGBA;
+                *p++ = (uint8_t)r;
+                *p++ = (uint8_t)g;
+                *p++ = (uint8_t)b;
+                *p++ = (uint8_t)a;
+            }
+        }
+        previous = c;
+    }
+    static const uint8_t END[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    memcpy(p, END, sizeof(END));
+    p += sizeof(END);
+    out.resize(p - out.data());
+}
+
+void EncodeFrame(FrameFormat format, const Argb* pixels, int width, int height, vector<uint8_t>& out) {
+    size_t count = (size_t)width * height;
+    switch (format) {
+    case FrameFormat::PPM: {
+        char header[32];
+        int headerSize = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", width, height);
+        out.resize(headerSize + count * 3);
+        memcpy(out.data(), header, headerSize);
+        uint8_t* p = out.data() + headerSize;
+        for (size_t i = 0; i < count; ++i, p += 3) {
+            p[0] = (uint8_t)(pixels[i] >> 16);
+            p[1] = (uint8_t)(pixels[i] >> 8);
+            p[2] = (uint8_t)pixels[i];
+        }
+        break;
+    }
+    case FrameFormat::RGBA: {
+        out.resize(count * 4);
+        uint8_t* p = out.data();
+        for (size_t i = 0; i < count; ++i, p += 4) {
+            p[0] = (uint8_t)(pixels[i] >> 16);
+            p[1] = (uint8_t)(pixels[i] >> 8);
+            p[2] = (uint8_t)pixels[i];
+            p[3] = (uint8_t)(pixels[i] >> 24);
+        }
+        break;
+    }
+    case FrameFormat::QOI:
+        EncodeQoi(pixels, width, height, out);
+        break;
+    }
+}
+
+// Kolejka numerów paczek między etapami. Pop czeka na element albo na zamknięcie kolejki.
+class StageQueue {
+public:
+    void Push(int item) {
+        lock_guard<mutex> lock(guard);
+        items.push_back(item);
+        ready.notify_one();
+    }
+    bool Pop(int& item) {
+        unique_lock<mutex> lock(guard);
+        ready.wait(lock, [&] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        item = items.front();
+        items.pop_front();
+        return true;
+    }
+    void Close() {
+        lock_guard<mutex> lock(guard);
+        closed = true;
+        ready.notify_all();
+    }
+
+private:
+    mutex guard;
+    condition_variable ready;
+    deque<int> items;
+    bool closed = false;
+};
+
+// Kolejne klatki od first; encoded[i] to klatka first + i.
+struct FrameBatch {
+    size_t first = 0;
+    size_t count = 0;
+    vector<SceneState> states;
+    vector<vector<uint8_t>> encoded;
+};
+
+struct FrameRenderer {
+    SoftwareBackend backend;
+    SceneRenderer scene{ backend };
+};
+
+size_t FrameExporter::PassengersPerFloor() const {
+    SoftwareBackend backend;
+    SceneRenderer scene(backend);
+    scene.SetViewport(options.width, options.height, options.scrollY);
+    return scene.PassengersPerFloor();
+}
+
+bool FrameExporter::Run(const CaptureFunction& capture, const WriteFunction& write, ExportStats& stats, string& error) {
+    // Trzy paczki: jedna zbierana, jedna rysowana i jedna zapisywana. Zadanie rysuje framesPerTask kolejnych klatek,
+    // a paczka ma dwa zadania na wątek, żeby podkradanie pracy wyrównało różne koszty klatek.
+    const int BATCHES = 3;
+    ThreadPool pool(options.threads);
+    size_t tasks = 2 * (size_t)pool.ThreadCount();
+    size_t frameBytes = (size_t)options.width * options.height * 4;
+    size_t framesPerTask = max<size_t>(1, min<size_t>(16, options.memoryBudget / (BATCHES * tasks * max<size_t>(1, frameBytes))));
+    size_t batchSize = tasks * framesPerTask;
+
+    vector<FrameBatch> batches(BATCHES);
+    for (auto& batch : batches) {
+        batch.states.resize(batchSize);
+        batch.encoded.resize(batchSize);
+    }
+    vector<unique_ptr<FrameRenderer>> renderers;
+    for (size_t i = 0; i < tasks; ++i) {
+        renderers.push_back(make_unique<FrameRenderer>());
+        FrameRenderer& r = *renderers.back();
+        r.backend.Resize(options.width, options.height);
+        r.scene.SetViewport(options.width, options.height, options.scrollY);
+        r.scene.SetInfoText(options.infoText);
+        r.scene.SetFullRedraw(true);
+    }
+
+    StageQueue free, captured, encoded;
+    for (int i = 0; i < BATCHES; ++i) free.Push(i);
+    atomic<bool> failed{ false };
+    string writeError;
+
+    thread captureThread([&] {
+        size_t next = 0;
+        bool done = false;
+        int b;
+        while (!done && !failed.load() && free.Pop(b)) {
+            FrameBatch& batch = batches[b];
+            batch.first = next;
+            batch.count = 0;
+            while (batch.count < batchSize) {
+                if (!capture(next, batch.states[batch.count])) {
+                    done = true;
+                    break;
+                }
+                batch.count++;
+                next++;
+            }
+            if (batch.count > 0) captured.Push(b);
+        }
+        captured.Close();
+    });
+    thread writeThread([&] {
+        int b;
+        while (encoded.Pop(b)) {
+            const FrameBatch& batch = batches[b];
+            for (size_t i = 0; i < batch.count && !failed.load(); ++i) {
+                if (!write(batch.first + i, batch.encoded[i], writeError)) {
+                    failed = true;
+                    break;
+                }
+                stats.frames++;
+                stats.bytes += batch.encoded[i].size();
+            }
+            // Po błędzie zapisu wątek symulacji nie dostaje już paczek i kończy pracę.
+            if (failed.load()) free.Close();
+            else free.Push(b);
+        }
+    });
+
+    int b;
+    while (captured.Pop(b)) {
+        FrameBatch& batch = batches[b];
+        if (!failed.load()) {
+            size_t used = (batch.count + framesPerTask - 1) / framesPerTask;
+            pool.ParallelFor(used, [&](size_t task) {
+                FrameRenderer& r = *renderers[task];
+                // Pierwsza klatka zadania jest rysowana w całości, kolejne tylko w zmienionych prostokątach.
+                r.scene.SetFullRedraw(true);
+                size_t end = min(batch.count, (task + 1) * framesPerTask);
+                for (size_t i = task * framesPerTask; i < end; ++i) {
+                    r.scene.Render(batch.states[i]);
+                    r.scene.SetFullRedraw(false);
+                    EncodeFrame(options.format, r.backend.Pixels(), options.width, options.height, batch.encoded[i]);
+                }
+            });
+        }
+        encoded.Push(b);
+    }
+    encoded.Close();
+    captureThread.join();
+    writeThread.join();
+    if (failed.load()) {
+        error = writeError;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "Scene.h"
+
+// Zapis klatki: PPM (P6, bez kanału alfa), surowe RGBA (4 bajty na piksel, bez nagłówka) albo QOI
+// (bezstratna kompresja, zwykle kilkadziesiąt razy mniejsza od surowej klatki dla płaskich kolorów sceny).
+enum class FrameFormat {
+    PPM,
+    RGBA,
+    QOI
+};
+
+const char* FrameFormatName(FrameFormat format);
+bool ParseFrameFormat(const std::string& name, FrameFormat& format);
+// Koduje klatkę do out; bufor jest używany ponownie, więc przy stałym rozmiarze nie przydziela pamięci.
+void EncodeFrame(FrameFormat format, const Argb* pixels, int width, int height, std::vector<uint8_t>& out);
+
+struct ExportOptions {
+    int width = 800;
+    int height = 600;
+    int scrollY = 0;
+    FrameFormat format = FrameFormat::PPM;
+    // Liczba wątków rysujących; <= 0 oznacza liczbę rdzeni.
+    int threads = 0;
+    // Ograniczenie pamięci klatek w potoku (stany, klatki zakodowane i czekające na zapis).
+    size_t memoryBudget = 256u << 20;
+    std::wstring infoText;
+};
+
+// Najmniejsza szerokość klatki dla carCount kabin: za ścianą budynku zostaje tyle miejsca co w domyślnej
+// klatce 800x600 z jedną kabiną.
+int FrameWidthForCars(int carCount);
+// Sprawdza, że prostokąt każdej kabiny (z obwódką, jak w SceneRenderer) mieści się w szerokości klatki.
+bool CarsFitFrame(const ExportOptions& options, int carCount, std::string& error);
+
+struct ExportStats {
+    size_t frames = 0;
+    uint64_t bytes = 0;
+};
+
+// Eksport klatek bez okna, w trzech etapach połączonych kolejkami o stałej liczbie paczek klatek:
+// wątek symulacji zbiera stany kolejnych klatek (capture), pula wątków rysuje i koduje paczkę równolegle
+// (każde zadanie to ciąg kolejnych klatek rysowanych przyrostowo jednym SceneRenderer), a wątek zapisu oddaje
+// klatki po kolei do write. Etapy pracują jednocześnie na różnych paczkach, a szybszy czeka na wolne miejsce.
+// Klatki są identyczne jak przy rysowaniu po kolei, bo przyrostowe rysowanie daje ten sam obraz co pełne.
+class FrameExporter {
+public:
+    // Wypełnia stan klatki numer frame; false kończy eksport.
+    typedef std::function<bool(size_t frame, SceneState& state)> CaptureFunction;
+    // Zapisuje zakodowaną klatkę; false przerywa eksport z błędem.
+    typedef std::function<bool(size_t frame, const std::vector<uint8_t>& data, std::string& error)> WriteFunction;
+
+    explicit FrameExporter(const ExportOptions& options) : options(options) {}
+
+    // Oczekujących na piętrze zbieranych do stanu: więcej nie mieści się w szerokości klatki.
+    size_t PassengersPerFloor() const;
+    bool Run(const CaptureFunction& capture, const WriteFunction& write, ExportStats& stats, std::string& error);
+
+private:
+    ExportOptions options;
+};
@@ -0,0 +1,104 @@
+﻿#include "GdiPlusRenderer.h"
+
+using namespace Gdiplus;
+using namespace std;
+
+GdiPlusBackend::~GdiPlusBackend() {
+    Release();
+}
+
+void GdiPlusBackend::Release() {
+    frameGraphics.reset();
+    backgroundGraphics.reset();
+    target = nullptr;
+    if (frameDC) {
+        DeleteDC(frameDC);
+        DeleteObject(frameBitmap);
+    }
+    if (backgroundDC) {
+        DeleteDC(backgroundDC);
+        DeleteObject(backgroundBitmap);
+    }
+    frameDC = backgroundDC = nullptr;
+    frameBitmap = backgroundBitmap = nullptr;
+}
+
+void GdiPlusBackend::Resize(int width, int height) {
+    Release();
+    HDC screen = GetDC(nullptr);
+    frameDC = CreateCompatibleDC(screen);
+    frameBitmap = CreateCompatibleBitmap(screen, max(1, width), max(1, height));
+    SelectObject(frameDC, frameBitmap);
+    backgroundDC = CreateCompatibleDC(screen);
+    backgroundBitmap = CreateCompatibleBitmap(screen, max(1, width), max(1, height));
+    SelectObject(backgroundDC, backgroundBitmap);
+    ReleaseDC(nullptr, screen);
+    frameGraphics = make_unique<Graphics>(frameDC);
+    backgroundGraphics = make_unique<Graphics>(backgroundDC);
+    target = frameGraphics.get();
+}
+
+void GdiPlusBackend::EndBackground() {
+    backgroundGraphics->Flush(FlushIntentionSync);
+    target = frameGraphics.get();
+}
+
+void GdiPlusBackend::RestoreBackground(const ScreenRect& rect) {
+    frameGraphics->Flush(FlushIntentionSync);
+    BitBlt(frameDC, rect.x, rect.y, rect.width, rect.height, backgroundDC, rect.x, rect.y, SRCCOPY);
+}
+
+void GdiPlusBackend::SetClip(const ScreenRect& rect) {
+    target->SetClip(Rect(rect.x, rect.y, rect.width, rect.height));
+}
+
+Pen& GdiPlusBackend::PenFor(Argb color, int width) {
+    auto& pen = pens[{ color, width }];
+    if (!pen) pen = make_unique<Pen>(Color(color), (REAL)width);
+    return *pen;
+}
+
+SolidBrush& GdiPlusBackend::BrushFor(Argb color) {
+    auto& brush = brushes[color];
+    if (!brush) brush = make_unique<SolidBrush>(Color(color));
+    return *brush;
+}
+
+Font& GdiPlusBackend::FontFor(int size) {
+    auto& font = fonts[size];
+    if (!font) font = make_unique<Font>(L"Arial", (REAL)size);
+    return *font;
+}
+
+void GdiPlusBackend::FillRectangle(const ScreenRect& rect, Argb color) {
+    target->FillRectangle(&BrushFor(color), rect.x, rect.y, rect.width, rect.height);
+}
+
+// Pędzel gradientu zależy tylko od kolorów i wysokości; na miejsce przesuwa go transformacja.
+void GdiPlusBackend::FillGradient(const ScreenRect& rect, Argb top, Argb bottom) {
+    auto& brush = gradients[make_tuple(top, bottom, rect.height)];
+    if (!brush) brush = make_unique<LinearGradientBrush>(Rect(0, 0, max(1, rect.width), max(1, rect.height)), Color(top), Color(bottom), LinearGradientModeVertical);
+    brush->ResetTransform();
+    brush->TranslateTransform((REAL)rect.x, (REAL)rect.y);
+    target->FillRectangle(brush.get(), rect.x, rect.y, rect.width, rect.height);
+}
+
+void GdiPlusBackend::DrawRectangle(const ScreenRect& rect, Argb color, int width) {
+    target->DrawRectangle(&PenFor(color, width), rect.x, rect.y, rect.width, rect.height);
+}
+
+void GdiPlusBackend::DrawLine(int x0, int y0, int x1, int y1, Argb color, int width) {
+    target->DrawLine(&PenFor(color, width), x0, y0, x1, y1);
+}
+
+void GdiPlusBackend::FillEllipse(const ScreenRect& rect, Argb color) {
+    target->FillEllipse(&BrushFor(color), rect.x, rect.y, rect.width, rect.height);
+}
+
+void GdiPlusBackend::DrawEllipse(const ScreenRect& rect, Argb color, int width) {
+    target->DrawEllipse(&PenFor(color, width), rect.x, rect.y, rect.width, rect.height);
+}
+
+void GdiPlusBackend::DrawLabel(int x, int y, const wstring& text, int size, Argb color) {
+    target->DrawString(text.c_str(), -1, &FontFor(size), PointF((REAL)x, (REAL)y), &BrushFor(color));
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include <windows.h>
+#include <gdiplus.h>
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "Renderer.h"
+
+// Rysowanie przez GDI+ do dwóch bitmap w pamięci: tła i klatki. Pióra, pędzle i czcionki są tworzone
+// przy pierwszym użyciu i trzymane do zniszczenia obiektu (przed GdiplusShutdown).
+class GdiPlusBackend : public RenderBackend {
+public:
+    GdiPlusBackend() = default;
+    ~GdiPlusBackend();
+    GdiPlusBackend(const GdiPlusBackend&) = delete;
+    GdiPlusBackend& operator=(const GdiPlusBackend&) = delete;
+
+    HDC FrameDC() const { return frameDC; }
+
+    void Resize(int width, int height) override;
+    void BeginBackground() override { target = backgroundGraphics.get(); }
+    void EndBackground() override;
+    void RestoreBackground(const ScreenRect& rect) override;
+    void SetClip(const ScreenRect& rect) override;
+    void ResetClip() override { target->ResetClip(); }
+    void EndFrame() override { frameGraphics->Flush(Gdiplus::FlushIntentionSync); }
+
+    void FillRectangle(const ScreenRect& rect, Argb color) override;
+    void FillGradient(const ScreenRect& rect, Argb top, Argb bottom) override;
+    void DrawRectangle(const ScreenRect& rect, Argb color, int width) override;
+    void DrawLine(int x0, int y0, int x1, int y1, Argb color, int width) override;
+    void FillEllipse(const ScreenRect& rect, Argb color) override;
+    void DrawEllipse(const ScreenRect& rect, Argb color, int width) override;
+    void DrawLabel(int x, int y, const std::wstring& text, int size, Argb color) override;
+
+private:
+    void Release();
+    Gdiplus::Pen& PenFor(Argb color, int width);
+    Gdiplus::SolidBrush& BrushFor(Argb color);
+    Gdiplus::Font& FontFor(int size);
+
+    HDC frameDC = nullptr;
+    HDC backgroundDC = nullptr;
+    HBITMAP frameBitmap = nullptr;
+    HBITMAP backgroundBitmap = nullptr;
+    std::unique_ptr<Gdiplus::Graphics> frameGraphics;
+    std::unique_ptr<Gdiplus::Graphics> backgroundGraphics;
+    Gdiplus::Graphics* target = nullptr;
+
+    std::map<std::pair<Argb, int>, std::unique_ptr<Gdiplus::Pen>> pens;
+    std::map<Argb, std::unique_ptr<Gdiplus::SolidBrush>> brushes;
+    std::map<int, std::unique_ptr<Gdiplus::Font>> fonts;
+    std::map<std::tuple<Argb, Argb, int>, std::unique_ptr<Gdiplus::LinearGradientBrush>> gradients;
+};
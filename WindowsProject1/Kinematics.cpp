@@ -0,0 +1,144 @@
+﻿#include "Kinematics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Simulation.h"
+
+using namespace std;
+
+const char* MotionModelName(MotionModel model) {
+    switch (model) {
+    case MotionModel::CONSTANT: return "constant";
+    case MotionModel::JERK: return "jerk";
+    }
+    return "?";
+}
+
+bool ParseMotionModel(const string& name, MotionModel& model) {
+    for (MotionModel m : { MotionModel::CONSTANT, MotionModel::JERK }) {
+        if (name == MotionModelName(m)) {
+            model = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Przyspieszanie trwa 2 * tj + ta i przebiega symetrycznie, więc średnia prędkość to połowa szczytowej.
+// Gdy dwa takie odcinki nie mieszczą się w distance, szczytowa prędkość v jest mniejsza niż limits.speed:
+// przy osiągniętym przyspieszeniu v^2 / a + v * a / j = distance, w przeciwnym razie 2 * v * sqrt(v / j) = distance.
+MotionProfile::MotionProfile(const MotionLimits& limits, double distance) : distance(max(distance, 0.0)) {
+    if (this->distance <= 0.0) return;
+    const double a = limits.acceleration;
+    const double j = limits.jerk;
+    double v = limits.speed;
+    double tj, ta, cruise = 0.0;
+    if (v * j >= a * a) {
+        tj = a / j;
+        ta = v / a - a / j;
+    }
+    else {
+        tj = sqrt(v / j);
+        ta = 0.0;
+    }
+    double accelerating = v * (2 * tj + ta) / 2;
+    if (2 * accelerating <= this->distance) {
+        cruise = (this->distance - 2 * accelerating) / v;
+    }
+    else {
+        v = (-a * a / j + sqrt(a * a * a * a / (j * j) + 4 * a * this->distance)) / 2;
+        if (v >= a * a / j) {
+            tj = a / j;
+            ta = v / a - a / j;
+        }
+        else {
+            v = pow(this->distance * sqrt(j) / 2, 2.0 / 3.0);
+            tj = sqrt(v / j);
+            ta = 0.0;
+        }
+    }
+
+    const double durations[PHASES] = { tj, ta, tj, cruise, tj, ta, tj };
+    const double jerks[PHASES] = { j, 0.0, -j, 0.0, -j, 0.0, j };
+    for (int i = 0; i < PHASES; ++i) {
+        double t = durations[i];
+        duration[i] = t;
+        jerk[i] = jerks[i];
+        begin[i + 1] = begin[i] + t;
+        position[i + 1] = position[i] + velocity[i] * t + acceleration[i] * t * t / 2 + jerks[i] * t * t * t / 6;
+        velocity[i + 1] = velocity[i] + acceleration[i] * t + jerks[i] * t * t / 2;
+        acceleration[i + 1] = acceleration[i] + jerks[i] * t;
+    }
+}
+
+int MotionProfile::PhaseAt(double t) const {
+    int phase = 0;
+    while (phase < PHASES - 1 && t >= begin[phase + 1]) phase++;
+    return phase;
+}
+
+double MotionProfile::Position(double t) const {
+    if (t <= 0.0) return 0.0;
+    if (t >= Duration()) return distance;
+    int i = PhaseAt(t);
+    double dt = t - begin[i];
+    double s = position[i] + velocity[i] * dt + acceleration[i] * dt * dt / 2 + jerk[i] * dt * dt * dt / 6;
+    return min(s, distance);
+}
+
+double MotionProfile::Velocity(double t) const {
+    if (t <= 0.0 || t >= Duration()) return 0.0;
+    int i = PhaseAt(t);
+    double dt = t - begin[i];
+    return max(0.0, velocity[i] + acceleration[i] * dt + jerk[i] * dt * dt / 2);
+}
+
+double MotionProfile::TimeAt(double s) const {
+    if (s <= 0.0) return 0.0;
+    if (s >= distance) return Duration();
+    int i = 0;
+    while (i < PHASES - 1 && position[i + 1] <= s) i++;
+    double low = begin[i];
+    double high = begin[i + 1];
+    for (int step = 0; step < 64; ++step) {
+        double middle = (low + high) / 2;
+        if (Position(middle) < s) low = middle;
+        else high = middle;
+    }
+    return high;
+}
+
+// W tej samej fazie oba profile mają ten sam zryw i ten sam stan na początku, więc pokrywają się do końca
+// krótszej z dwóch faz. Różnica czasu trwania fazy kończy wspólny odcinek.
+double MotionProfile::SharedUntil(const MotionProfile& shorter) const {
+    if (shorter.distance <= 0.0) return 0.0;
+    for (int i = 0; i < PHASES; ++i) {
+        if (duration[i] != shorter.duration[i]) return begin[i] + min(duration[i], shorter.duration[i]);
+    }
+    return Duration();
+}
+
+MotionLimits MotionLimitsFor(const BuildingConfig& config) {
+    MotionLimits limits;
+    limits.speed = config.ratedSpeed;
+    limits.acceleration = config.acceleration;
+    limits.jerk = config.jerk;
+    return limits;
+}
+
+TravelTime::TravelTime(const BuildingConfig& config)
+    : constant(config.motionModel == MotionModel::CONSTANT),
+      floorTime(config.floorHeight / config.elevatorSpeed * TICK_DURATION),
+      limits(MotionLimitsFor(config)),
+      floorMeters(config.floorHeightMeters) {}
+
+float TravelTime::operator()(float floors) const {
+    if (constant) return floors * floorTime;
+    return (float)(MotionProfile(limits, floors * floorMeters).Duration() * 1000.0);
+}
+
+float TravelTime::operator()(float first, float second) const {
+    if (constant) return (first + second) * floorTime;
+    return (*this)(first) + (*this)(second);
+}
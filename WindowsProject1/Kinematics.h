@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#include <string>
+
+struct BuildingConfig;
+
+// Model ruchu kabiny. CONSTANT przesuwa kabinę o stałą liczbę pikseli na krok (ruszanie i hamowanie
+// w miejscu), JERK jedzie według MotionProfile w jednostkach fizycznych, niezależnie od długości kroku.
+enum class MotionModel {
+    CONSTANT,
+    JERK
+};
+
+const char* MotionModelName(MotionModel model);
+bool ParseMotionModel(const std::string& name, MotionModel& model);
+
+// Ograniczenia ruchu: prędkość w m/s, przyspieszenie w m/s², zryw w m/s³.
+struct MotionLimits {
+    double speed = 0.0;
+    double acceleration = 0.0;
+    double jerk = 0.0;
+};
+
+// Najkrótszy przejazd z postoju do postoju na odległość distance (m) przy ograniczeniach: przyspieszanie
+// (zryw +j, stałe przyspieszenie, zryw -j), jazda ze stałą prędkością i symetryczne hamowanie. Położenie
+// w każdej z 7 faz jest wielomianem czasu, więc przejazd można odczytać w dowolnej chwili bez kroków.
+// Na krótkich odcinkach fazy stałego przyspieszenia i stałej prędkości znikają.
+class MotionProfile {
+public:
+    static const int PHASES = 7;
+
+    MotionProfile() = default;
+    MotionProfile(const MotionLimits& limits, double distance);
+
+    double Distance() const { return distance; }
+    double Duration() const { return begin[PHASES]; }
+    // Droga i prędkość po t sekundach od startu; poza [0, Duration()] kabina stoi.
+    double Position(double t) const;
+    double Velocity(double t) const;
+    // Chwila, w której przejechana droga osiąga s. Położenie w fazie jest rosnące, więc w obrębie
+    // znalezionej fazy wystarcza bisekcja.
+    double TimeAt(double s) const;
+    // Do której chwili przejazd shorter (z tego samego miejsca, nie dalej) przebiega tak samo jak ten.
+    // Kabina jadąca według tego profilu może w chwili t zatrzymać się w celu shorter, jeśli t <= wynik.
+    double SharedUntil(const MotionProfile& shorter) const;
+
+private:
+    int PhaseAt(double t) const;
+
+    double distance = 0.0;
+    double duration[PHASES] = {};
+    double jerk[PHASES] = {};
+    // Czas początku fazy oraz droga, prędkość i przyspieszenie na jej początku.
+    double begin[PHASES + 1] = {};
+    double position[PHASES + 1] = {};
+    double velocity[PHASES + 1] = {};
+    double acceleration[PHASES + 1] = {};
+};
+
+MotionLimits MotionLimitsFor(const BuildingConfig& config);
+
+// Czas przejazdu o floors pięter od postoju do postoju w ms, w modelu ruchu z konfiguracji.
+// Dyspozytorzy szacują nim czasy dojazdu zamiast symulować kroki.
+class TravelTime {
+public:
+    explicit TravelTime(const BuildingConfig& config);
+    float operator()(float floors) const;
+    // Dwa odcinki z postojem po drodze.
+    float operator()(float first, float second) const;
+
+private:
+    bool constant;
+    float floorTime;
+    MotionLimits limits;
+    double floorMeters;
+};
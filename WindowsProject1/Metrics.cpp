@@ -0,0 +1,106 @@
+﻿#include "Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "FloorSet.h"
+
+using namespace std;
+
+int Histogram::BucketIndex(uint32_t value) {
+    if (value < (uint32_t)SUB_BUCKETS) return (int)value;
+    int magnitude = HighestBit(value);
+    int shift = magnitude - (SUB_BUCKET_BITS - 1);
+    return SUB_BUCKETS + (magnitude - SUB_BUCKET_BITS) * HALF_BUCKETS + (int)(value >> shift) - HALF_BUCKETS;
+}
+
+uint32_t Histogram::BucketEnd(int index) {
+    if (index < SUB_BUCKETS) return (uint32_t)index;
+    int k = index - SUB_BUCKETS;
+    int magnitude = k / HALF_BUCKETS + SUB_BUCKET_BITS;
+    uint64_t sub = (uint64_t)(k % HALF_BUCKETS + HALF_BUCKETS);
+    int shift = magnitude - (SUB_BUCKET_BITS - 1);
+    return (uint32_t)min<uint64_t>(((sub + 1) << shift) - 1, UINT32_MAX);
+}
+
+void Histogram::Record(uint32_t value) {
+    counts[BucketIndex(value)]++;
+    count++;
+    sum += value;
+    if (value > max) max = value;
+}
+
+uint32_t Histogram::Percentile(double percentile) const {
+    if (count == 0) return 0;
+    uint64_t rank = (uint64_t)ceil(percentile / 100.0 * count);
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(BucketEnd(i), max);
+    }
+    return max;
+}
+
+CarStats SimulationMetrics::Total() const {
+    CarStats total;
+    for (const auto& car : cars) {
+        total.stops += car.stops;
+        total.trips += car.trips;
+        total.reversals += car.reversals;
+        total.floorsTravelled += car.floorsTravelled;
+        total.passengerFloors += car.passengerFloors;
+    }
+    return total;
+}
+
+double SimulationMetrics::LoadFactor(int capacity) const {
+    CarStats total = Total();
+    if (total.floorsTravelled == 0 || capacity <= 0) return 0.0;
+    uint64_t deckFloors = 0;
+    for (const auto& car : cars) deckFloors += car.floorsTravelled * car.decks;
+    return (double)total.passengerFloors / ((double)deckFloors * capacity);
+}
+
+void SimulationMetrics::RecordDelivery(uint32_t time) {
+    if (time - windowStart >= CAPACITY_WINDOW) {
+        if (windowDelivered > bestWindow) bestWindow = windowDelivered;
+        windowStart = time - time % CAPACITY_WINDOW;
+        windowDelivered = 0;
+    }
+    windowDelivered++;
+}
+
+static void PrintTimes(FILE* out, const char* name, const Histogram& h) {
+    fprintf(out, "%s %8.1f %8.1f %8.1f %8.1f %8.1f\n", name,
+        h.Mean() / 1000.0, h.Percentile(50) / 1000.0, h.Percentile(95) / 1000.0, h.Percentile(99) / 1000.0, h.Max() / 1000.0);
+}
+
+void PrintMetricsSummary(FILE* out, const SimulationMetrics& metrics, int capacity) {
+    CarStats total = metrics.Total();
+    fprintf(out, "Czasy [s]          średnia      p50      p95      p99     maks\n");
+    PrintTimes(out, "  czekanie        ", metrics.wait);
+    PrintTimes(out, "  jazda           ", metrics.ride);
+    PrintTimes(out, "  podróż          ", metrics.journey);
+    fprintf(out, "Zapełnienie kabin:    %.1f%%\n", metrics.LoadFactor(capacity) * 100.0);
+    fprintf(out, "Postoje:              %llu (%.2f na kurs)\n", (unsigned long long)total.stops,
+        total.trips ? (double)total.stops / total.trips : 0.0);
+    fprintf(out, "Przejechane piętra:   %llu\n", (unsigned long long)total.floorsTravelled);
+    fprintf(out, "Zmiany kierunku:      %llu\n", (unsigned long long)total.reversals);
+    fprintf(out, "Przepustowość:        %u osób / 5 min\n", (unsigned)metrics.HandlingCapacity());
+}
+
+void WriteMetricsHeader(FILE* out) {
+    fputs("time_ms,delivered,wait_p50,wait_p95,wait_p99,ride_p50,ride_p95,ride_p99,journey_p50,journey_p95,journey_p99,"
+        "load_factor,stops,trips,floors,reversals\n", out);
+}
+
+void WriteMetricsRow(FILE* out, uint32_t time, const SimulationMetrics& metrics, int capacity) {
+    CarStats total = metrics.Total();
+    fprintf(out, "%u,%llu", (unsigned)time, (unsigned long long)metrics.journey.Count());
+    for (const Histogram* h : { &metrics.wait, &metrics.ride, &metrics.journey }) {
+        fprintf(out, ",%u,%u,%u", (unsigned)h->Percentile(50), (unsigned)h->Percentile(95), (unsigned)h->Percentile(99));
+    }
+    fprintf(out, ",%.4f,%llu,%llu,%llu,%llu\n", metrics.LoadFactor(capacity), (unsigned long long)total.stops,
+        (unsigned long long)total.trips, (unsigned long long)total.floorsTravelled, (unsigned long long)total.reversals);
+}
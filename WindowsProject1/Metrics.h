@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Histogram czasów w ms w stylu HDR: wartości poniżej 128 mają własne kubełki, wyżej każda potęga dwójki
+// dzieli się na 64 kubełki, więc błąd względny percentyla nie przekracza 1/64. Record kosztuje kilka instrukcji.
+class Histogram {
+public:
+    static const int SUB_BUCKET_BITS = 7;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int HALF_BUCKETS = SUB_BUCKETS / 2;
+    static const int BUCKET_COUNT = SUB_BUCKETS + (32 - SUB_BUCKET_BITS) * HALF_BUCKETS;
+
+    Histogram() : counts(BUCKET_COUNT, 0) {}
+
+    void Record(uint32_t value);
+    uint64_t Count() const { return count; }
+    uint64_t Sum() const { return sum; }
+    uint32_t Max() const { return max; }
+    double Mean() const { return count ? (double)sum / count : 0.0; }
+    // Najmniejsza wartość, od której nie jest większe percentile% pomiarów (górna granica kubełka).
+    uint32_t Percentile(double percentile) const;
+
+private:
+    friend struct SnapshotAccess;
+
+    static int BucketIndex(uint32_t value);
+    static uint32_t BucketEnd(int index);
+
+    std::vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint32_t max = 0;
+};
+
+// Liczniki jednej kabiny. Odległość jest liczona w piętrach przy każdym postoju,
+// bo między postojami kabina jedzie w jednym kierunku.
+struct CarStats {
+    uint64_t stops = 0;
+    uint64_t trips = 0;
+    uint64_t reversals = 0;
+    uint64_t floorsTravelled = 0;
+    // Suma (liczba osób w kabinie * przejechane piętra), do współczynnika zapełnienia.
+    uint64_t passengerFloors = 0;
+    // Pokłady kabiny; pojemność kabiny dwupokładowej jest podwójna.
+    int decks = 1;
+
+    int lastStopFloor = -1;
+    int lastTravelDirection = 0;
+};
+
+struct SimulationMetrics {
+    // Przepustowość liczona w kolejnych oknach po 5 minut (od chwili 0).
+    static const uint32_t CAPACITY_WINDOW = 5u * 60u * 1000u;
+
+    Histogram wait;
+    Histogram ride;
+    Histogram journey;
+    std::vector<CarStats> cars;
+    uint32_t windowStart = 0;
+    uint32_t windowDelivered = 0;
+    uint32_t bestWindow = 0;
+
+    CarStats Total() const;
+    void RecordDelivery(uint32_t time);
+    // Najwięcej osób dowiezionych w jednym oknie CAPACITY_WINDOW; przy ruchu up-peak ponad możliwości
+    // kabin to przepustowość zespołu wind (handling capacity).
+    uint32_t HandlingCapacity() const { return bestWindow > windowDelivered ? bestWindow : windowDelivered; }
+    // capacity to liczba osób mieszczących się w kabinie (na jednym pokładzie).
+    double LoadFactor(int capacity) const;
+};
+
+void PrintMetricsSummary(FILE* out, const SimulationMetrics& metrics, int capacity);
+void WriteMetricsHeader(FILE* out);
+// Jeden wiersz CSV ze stanem od początku symulacji do chwili time.
+void WriteMetricsRow(FILE* out, uint32_t time, const SimulationMetrics& metrics, int capacity);
@@ -0,0 +1,92 @@
+﻿#include "Parking.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const char* ParkingPolicyName(ParkingPolicy policy) {
+    switch (policy) {
+    case ParkingPolicy::GROUND: return "ground";
+    case ParkingPolicy::DEMAND: return "demand";
+    }
+    return "?";
+}
+
+bool ParseParkingPolicy(const string& name, ParkingPolicy& policy) {
+    for (ParkingPolicy p : { ParkingPolicy::GROUND, ParkingPolicy::DEMAND }) {
+        if (name == ParkingPolicyName(p)) {
+            policy = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+double DecayedCounts::Weight(uint32_t time) const {
+    return exp2(((double)time - (double)base) / halfLife);
+}
+
+double DecayedCounts::Rescale(uint32_t time) {
+    if (time < base || (time - base) / halfLife <= 32) return 1.0;
+    uint32_t halves = (time - base) / halfLife;
+    double scale = ldexp(1.0, -(int)halves);
+    for (double& value : values) value *= scale;
+    base += halves * halfLife;
+    return scale;
+}
+
+DemandModel::DemandModel(int floorCount, uint32_t slotLength, uint32_t halfLife)
+    : floorCount(floorCount), slotLength(slotLength) {
+    int slotCount = (int)(DAY / slotLength);
+    recent.halfLife = halfLife;
+    recent.values.assign(floorCount, 0.0);
+    slots.halfLife = SLOT_HALF_LIFE;
+    slots.values.assign((size_t)slotCount * floorCount, 0.0);
+    slotTotals.assign(slotCount, 0.0);
+    slotLast.assign(slotCount, 0.0);
+}
+
+void DemandModel::Record(int floor, int count, uint32_t time) {
+    if (floor < 0 || floor >= floorCount) return;
+    recentTotal *= recent.Rescale(time);
+    double scale = slots.Rescale(time);
+    if (scale != 1.0) {
+        for (double& total : slotTotals) total *= scale;
+        for (double& last : slotLast) last *= scale;
+    }
+
+    double weight = recent.Weight(time) * count;
+    recent.values[floor] += weight;
+    recentTotal += weight;
+
+    int slot = Slot(time);
+    double slotWeight = slots.Weight(time);
+    slots.values[(size_t)slot * floorCount + floor] += slotWeight * count;
+    slotTotals[slot] += slotWeight * count;
+    slotLast[slot] = slotWeight;
+}
+
+int DemandModel::ParkingFloor(uint32_t time, int rank, int parked, int fallback) const {
+    if (recentTotal <= 0.0) return fallback;
+    int slot = Slot(time);
+    double share = 0.0;
+    if (slotTotals[slot] > 0.0) {
+        double calls = slotTotals[slot] / slotLast[slot];
+        share = calls / (calls + PRIOR_CALLS);
+    }
+    double slotScale = share > 0.0 ? share / slotTotals[slot] : 0.0;
+    double recentScale = (1.0 - share) / recentTotal;
+    const double* slotValues = &slots.values[(size_t)slot * floorCount];
+    double quantile = (rank + 0.5) / parked;
+    double cumulative = 0.0;
+    for (int floor = 0; floor < floorCount - 1; ++floor) {
+        cumulative += slotValues[floor] * slotScale + recent.values[floor] * recentScale;
+        if (cumulative >= quantile) return floor;
+    }
+    return floorCount - 1;
+}
+
+uint32_t DemandModel::SlotEnd(uint32_t time) const {
+    return (uint32_t)min<uint64_t>(((uint64_t)time / slotLength + 1) * slotLength, UINT32_MAX);
+}
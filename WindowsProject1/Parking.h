@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Gdzie czeka wolna kabina po idleReturnDelay: GROUND - na parterze, DEMAND - tam, skąd według
+// DemandModel najpewniej przyjdzie następne wezwanie.
+enum class ParkingPolicy {
+    GROUND,
+    DEMAND
+};
+
+const char* ParkingPolicyName(ParkingPolicy policy);
+bool ParseParkingPolicy(const std::string& name, ParkingPolicy& policy);
+
+// Liczniki z wykładniczym zanikaniem: wezwanie sprzed halfLife ms waży połowę bieżącego. Zamiast mnożyć
+// wszystkie liczniki przy każdym wezwaniu, nowe wezwanie waży 2^((time - base) / halfLife), więc stosunki
+// liczników nie zależą od chwili odczytu. Gdy wagi rosną za bardzo, wszystko jest dzielone, a base przesuwane.
+struct DecayedCounts {
+    uint32_t halfLife = 1;
+    uint32_t base = 0;
+    std::vector<double> values;
+
+    double Weight(uint32_t time) const;
+    // Przesuwa base tak, żeby waga w chwili time była nie większa niż 2^32, i mnoży values przez zwracany
+    // czynnik (1, gdy nic się nie zmieniło); inne liczniki w tej samej skali mnoży wywołujący.
+    double Rescale(uint32_t time);
+};
+
+// Model popytu: ile wezwań przychodzi z każdego piętra, osobno dla każdej pory dnia (przedziały slotLength ms,
+// pamięć ok. tygodnia) i dla ostatnich kilkudziesięciu minut (halfLife ms). Record to O(1). ParkingFloor łączy
+// przedział bieżącej pory dnia z ostatnimi wezwaniami (im więcej wezwań zna przedział, tym większa jego waga)
+// i zwraca kwantyl rozkładu pięter: dla jednej wolnej kabiny medianę, czyli piętro o najmniejszej oczekiwanej
+// odległości od następnego wezwania, a dla m kabin środek rank-tej z m równych części. O(liczba pięter).
+class DemandModel {
+public:
+    static const uint32_t DAY = 24u * 60u * 60u * 1000u;
+    static const uint32_t SLOT_HALF_LIFE = 7u * DAY;
+    // Tyle wezwań musi znać przedział pory dnia, żeby ważył tyle co ostatnie wezwania.
+    static constexpr double PRIOR_CALLS = 8.0;
+
+    DemandModel() = default;
+    DemandModel(int floorCount, uint32_t slotLength, uint32_t halfLife);
+
+    void Record(int floor, int count, uint32_t time);
+    // Piętro postoju kabiny rank (0 = najwyżej) spośród parked wolnych kabin; fallback, dopóki nie było wezwań.
+    // Wynik zmienia się tylko po Record i na granicy przedziałów pory dnia (SlotEnd).
+    int ParkingFloor(uint32_t time, int rank, int parked, int fallback) const;
+    // Pierwsza chwila następnego przedziału pory dnia.
+    uint32_t SlotEnd(uint32_t time) const;
+
+private:
+    friend struct SnapshotAccess;
+
+    int Slot(uint32_t time) const { return (int)(time % DAY / slotLength); }
+
+    int floorCount = 0;
+    uint32_t slotLength = DAY;
+    DecayedCounts recent;
+    double recentTotal = 0.0;
+    // slots.values[slot * floorCount + floor]; slotLast to waga ostatniego wezwania w przedziale,
+    // więc slotTotals / slotLast to liczba wezwań przeliczona na tę chwilę.
+    DecayedCounts slots;
+    std::vector<double> slotTotals;
+    std::vector<double> slotLast;
+};
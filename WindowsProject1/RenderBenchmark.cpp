@@ -0,0 +1,179 @@
+﻿#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "Dispatcher.h"
+#include "Scene.h"
+#include "Simulation.h"
+#include "SimulationThread.h"
+#include "SoftwareRenderer.h"
+
+using namespace std;
+
+void PrintUsage(const char* name) {
+    fprintf(stderr,
+        "Użycie: %s [--passengers N] [--frames N] [--floors N] [--cars N] [--size SZERxWYS] [--check] [--ppm plik]\n"
+        "       %s --live PRĘDKOŚĆ [--seconds N] [--passengers N] [--floors N] [--cars N] [--size SZERxWYS]\n"
+        "  --passengers  oczekujący na widocznych piętrach na początku (domyślnie 500)\n"
+        "  --check       porównuje obie klatki po każdym kroku, a nie tylko na końcu\n"
+        "  --ppm         zapisuje ostatnią klatkę\n"
+        "  --live        symulacja we własnym wątku, PRĘDKOŚĆ razy szybciej niż czas rzeczywisty,\n"
+        "                i rysowanie klatek co 16 ms przez --seconds sekund (domyślnie 5)\n",
+        name, name);
+}
+
+// Wątek symulacji działa z zadaną prędkością, a ten wątek rysuje klatki pośrednie w stałym tempie.
+// Raportowana jest prędkość faktycznie osiągnięta przez symulację i czasy klatek.
+int RunLive(const BuildingConfig& config, vector<pair<int, int>> calls, double speed, double seconds, int width, int height) {
+    const auto frameInterval = chrono::milliseconds(16);
+    SimulationThread simulation(config);
+    SoftwareBackend backend;
+    SceneRenderer scene(backend);
+    SceneInterpolator interpolator;
+    backend.Resize(width, height);
+    scene.SetViewport(width, height, 0);
+    simulation.SetPassengersPerFloor(scene.PassengersPerFloor());
+    simulation.SetSpeed(speed);
+    simulation.Start();
+
+    auto clockStart = chrono::steady_clock::now();
+    auto msSince = [&](chrono::steady_clock::time_point t) { return chrono::duration<double, milli>(t - clockStart).count(); };
+    size_t nextCall = 0;
+    int frames = 0, states = 0;
+    double renderSeconds = 0.0, worstFrame = 0.0;
+    auto nextFrame = clockStart;
+    while (msSince(chrono::steady_clock::now()) < seconds * 1000.0) {
+        while (nextCall < calls.size() && simulation.Call(calls[nextCall].first, calls[nextCall].second)) nextCall++;
+        this_thread::sleep_until(nextFrame);
+        nextFrame += frameInterval;
+        auto start = chrono::steady_clock::now();
+        if (simulation.Update()) {
+            interpolator.Receive(simulation.Latest(), msSince(start));
+            states++;
+        }
+        if (interpolator.HasState()) scene.Render(interpolator.Frame(msSince(start)));
+        double frameSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        renderSeconds += frameSeconds;
+        worstFrame = max(worstFrame, frameSeconds);
+        frames++;
+    }
+    double elapsed = msSince(chrono::steady_clock::now());
+    simulation.Stop();
+
+    double simulated = (double)simulation.Steps() * TICK_DURATION;
+    printf("Czas rzeczywisty:       %.2f s\n", elapsed / 1000.0);
+    printf("Czas symulowany:        %.2f s (x%.1f, zadane x%.1f)\n", simulated / 1000.0, simulated / elapsed, speed);
+    printf("Kroki symulacji:        %llu\n", (unsigned long long)simulation.Steps());
+    printf("Odebrane stany:         %d\n", states);
+    printf("Klatki:                 %d (%dx%d)\n", frames, width, height);
+    printf("Rysowanie klatki:       %.1f us średnio, %.1f us najdłużej\n", renderSeconds / max(1, frames) * 1e6, worstFrame * 1e6);
+    return 0;
+}
+
+// Ta sama symulacja jest rysowana dwa razy: z przerysowaniem zmienionych prostokątów i w całości.
+// Czasy klatek są mierzone osobno, a obrazy muszą być identyczne.
+int main(int argc, char** argv) {
+    int passengerCount = 500;
+    int frames = 2000;
+    int width = 1000, height = 900;
+    bool checkEveryFrame = false;
+    const char* ppmPath = nullptr;
+    double liveSpeed = 0.0, liveSeconds = 5.0;
+    BuildingConfig config;
+    config.floorCount = 20;
+    config.carCount = 4;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--passengers") && i + 1 < argc) passengerCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--floors") && i + 1 < argc) config.floorCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--cars") && i + 1 < argc) config.carCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--size") && i + 1 < argc) sscanf(argv[++i], "%dx%d", &width, &height);
+        else if (!strcmp(argv[i], "--check")) checkEveryFrame = true;
+        else if (!strcmp(argv[i], "--ppm") && i + 1 < argc) ppmPath = argv[++i];
+        else if (!strcmp(argv[i], "--live") && i + 1 < argc) liveSpeed = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) liveSeconds = atof(argv[++i]);
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    string error;
+    if (!ValidateBuildingConfig(config, error) || width <= 0 || height <= 0) {
+        fprintf(stderr, "Błędne parametry: %s\n", error.c_str());
+        return 1;
+    }
+
+    mt19937 rng(1);
+    int visibleFloors = min(config.floorCount, height / config.floorHeight);
+    uniform_int_distribution<int> startDist(0, visibleFloors - 1);
+    uniform_int_distribution<int> targetDist(0, config.floorCount - 1);
+    vector<pair<int, int>> calls;
+    for (int i = 0; i < passengerCount; ++i) {
+        int start = startDist(rng), target;
+        do target = targetDist(rng); while (target == start);
+        calls.push_back({ start, target });
+    }
+    if (liveSpeed > 0.0) return RunLive(config, calls, liveSpeed, liveSeconds, width, height);
+
+    ManualClock clock;
+    ElevatorBank bank(clock, config);
+    for (const auto& call : calls) bank.AddPassenger(call.first, call.second);
+
+    SoftwareBackend dirtyBackend, fullBackend;
+    SceneRenderer dirtyScene(dirtyBackend), fullScene(fullBackend);
+    fullScene.SetFullRedraw(true);
+    for (SoftwareBackend* backend : { &dirtyBackend, &fullBackend }) backend->Resize(width, height);
+    for (SceneRenderer* scene : { &dirtyScene, &fullScene }) {
+        scene->SetViewport(width, height, 0);
+        scene->SetInfoText(L"Wybierz piętra i naciśnij Wezwij.");
+    }
+
+    auto sameFrame = [&] {
+        return memcmp(dirtyBackend.Pixels(), fullBackend.Pixels(), sizeof(Argb) * width * height) == 0;
+    };
+    double dirtySeconds = 0.0, fullSeconds = 0.0;
+    double dirtyArea = 0.0;
+    size_t sprites = 0;
+    SceneState state;
+    bool identical = true;
+    for (int frame = 0; frame < frames; ++frame) {
+        clock.Advance(TICK_DURATION);
+        bank.MoveElevator();
+        CaptureScene(bank, dirtyScene.PassengersPerFloor(), state);
+
+        auto start = chrono::steady_clock::now();
+        const vector<ScreenRect>& dirty = dirtyScene.Render(state);
+        auto middle = chrono::steady_clock::now();
+        fullScene.Render(state);
+        auto end = chrono::steady_clock::now();
+        // Pierwsza klatka rysuje tło w obu trybach, więc nie jest liczona.
+        if (frame == 0) continue;
+        dirtySeconds += chrono::duration<double>(middle - start).count();
+        fullSeconds += chrono::duration<double>(end - middle).count();
+        for (const auto& r : dirty) dirtyArea += (double)r.width * r.height;
+        sprites += dirtyScene.SpriteCount();
+        if (checkEveryFrame && identical && !sameFrame()) {
+            fprintf(stderr, "Klatka %d różni się od rysowanej w całości\n", frame);
+            identical = false;
+        }
+    }
+    identical = identical && sameFrame();
+
+    int measured = max(1, frames - 1);
+    printf("Klatki:                 %d (%dx%d)\n", frames, width, height);
+    printf("Elementy sceny:         %.0f na klatkę\n", (double)sprites / measured);
+    printf("Przerysowany obszar:    %.1f%%\n", 100.0 * dirtyArea / measured / ((double)width * height));
+    printf("Prostokąty zmian:       %.1f us/klatkę\n", dirtySeconds / measured * 1e6);
+    printf("Cała klatka:            %.1f us/klatkę\n", fullSeconds / measured * 1e6);
+    printf("Obrazy identyczne:      %s\n", identical ? "tak" : "nie");
+    if (ppmPath && !dirtyBackend.WritePpm(ppmPath)) {
+        fprintf(stderr, "Nie można zapisać %s\n", ppmPath);
+        return 1;
+    }
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+// Kolor 0xAARRGGBB, ten sam układ co Gdiplus::ARGB.
+typedef uint32_t Argb;
+
+inline Argb MakeArgb(int r, int g, int b) {
+    return 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+}
+
+struct ScreenRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    int Right() const { return x + width; }
+    int Bottom() const { return y + height; }
+    bool Empty() const { return width <= 0 || height <= 0; }
+};
+
+inline ScreenRect Intersect(const ScreenRect& a, const ScreenRect& b) {
+    int left = (std::max)(a.x, b.x), top = (std::max)(a.y, b.y);
+    int right = (std::min)(a.Right(), b.Right()), bottom = (std::min)(a.Bottom(), b.Bottom());
+    if (right <= left || bottom <= top) return ScreenRect();
+    return { left, top, right - left, bottom - top };
+}
+
+inline ScreenRect Union(const ScreenRect& a, const ScreenRect& b) {
+    if (a.Empty()) return b;
+    if (b.Empty()) return a;
+    int left = (std::min)(a.x, b.x), top = (std::min)(a.y, b.y);
+    return { left, top, (std::max)(a.Right(), b.Right()) - left, (std::max)(a.Bottom(), b.Bottom()) - top };
+}
+
+inline bool Overlaps(const ScreenRect& a, const ScreenRect& b) {
+    return a.x < b.Right() && b.x < a.Right() && a.y < b.Bottom() && b.y < a.Bottom();
+}
+
+// Cel rysowania sceny. Ma dwie warstwy: tło (budynek), rysowane raz, i klatkę, do której
+// RestoreBackground kopiuje fragment tła przed narysowaniem ruchomych elementów.
+// Współrzędne są ekranowe, grubości i rozmiary czcionek jak w GDI+ (rozmiar w punktach).
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual void Resize(int width, int height) = 0;
+    // Między BeginBackground i EndBackground rysowanie trafia do warstwy tła.
+    virtual void BeginBackground() = 0;
+    virtual void EndBackground() = 0;
+    virtual void RestoreBackground(const ScreenRect& rect) = 0;
+    virtual void SetClip(const ScreenRect& rect) = 0;
+    virtual void ResetClip() = 0;
+    // Wywoływane po narysowaniu klatki, zanim zostanie pokazana.
+    virtual void EndFrame() {}
+
+    virtual void FillRectangle(const ScreenRect& rect, Argb color) = 0;
+    virtual void FillGradient(const ScreenRect& rect, Argb top, Argb bottom) = 0;
+    virtual void DrawRectangle(const ScreenRect& rect, Argb color, int width) = 0;
+    virtual void DrawLine(int x0, int y0, int x1, int y1, Argb color, int width) = 0;
+    virtual void FillEllipse(const ScreenRect& rect, Argb color) = 0;
+    virtual void DrawEllipse(const ScreenRect& rect, Argb color, int width) = 0;
+    virtual void DrawLabel(int x, int y, const std::wstring& text, int size, Argb color) = 0;
+};
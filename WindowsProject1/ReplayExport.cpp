@@ -0,0 +1,201 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "Dispatcher.h"
+#include "EventScheduler.h"
+#include "FrameExport.h"
+#include "Simulation.h"
+#include "Trace.h"
+
+using namespace std;
+
+void PrintUsage(const char* name) {
+    fprintf(stderr,
+        "Użycie: %s [plik_ruchu] [--traffic poisson|up-peak|down-peak|lunch] [--rate N] [--duration MS] [--seed S]\n"
+        "          [--config plik] [--cars N] [--dispatcher nearest|eta|destination] --out katalog|-\n"
+        "          [--format ppm|rgba|qoi] [--fps N] [--from MS] [--to MS] [--size SZERxWYS] [--scroll PX]\n"
+        "          [--threads N] [--memory MB]\n"
+        "  plik_ruchu  jak w elevator_runner; zamiast niego ruch z --traffic\n"
+        "  --out       katalog na pliki frame_NNNNNN.<format> albo - (klatki jedna po drugiej na standardowe\n"
+        "              wyjście, np. dla ffmpeg -f image2pipe przy ppm albo -f rawvideo -pix_fmt rgba przy rgba)\n"
+        "  --fps       klatki na sekundę czasu symulacji (domyślnie 30)\n"
+        "  --from/--to przedział czasu symulacji; bez --to do chwili, gdy w budynku nikogo nie ma\n"
+        "  --size      rozmiar klatki (domyślnie 800x600, szersza, gdy nie mieszczą się kabiny); --scroll przesuwa\n"
+        "              widok w dół budynku\n"
+        "  --threads   wątki rysujące (domyślnie wszystkie rdzenie)\n"
+        "  --memory    pamięć na klatki w potoku (domyślnie 256 MB)\n",
+        name);
+}
+
+int main(int argc, char** argv) {
+    const char* tracePath = nullptr;
+    const char* trafficName = nullptr;
+    double rate = 600.0;
+    uint32_t duration = 60u * 60u * 1000u;
+    unsigned seed = 1;
+    int carCount = 0;
+    const char* configPath = nullptr;
+    string dispatcherName = "nearest";
+    const char* outPath = nullptr;
+    string formatName = "ppm";
+    int fps = 30;
+    uint32_t from = 0, to = 0;
+    bool sizeGiven = false;
+    ExportOptions options;
+    options.infoText = L"Zapis przebiegu.";
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--traffic") && i + 1 < argc) trafficName = argv[++i];
+        else if (!strcmp(argv[i], "--rate") && i + 1 < argc) rate = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--duration") && i + 1 < argc) duration = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--config") && i + 1 < argc) configPath = argv[++i];
+        else if (!strcmp(argv[i], "--cars") && i + 1 < argc) carCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--dispatcher") && i + 1 < argc) dispatcherName = argv[++i];
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) outPath = argv[++i];
+        else if (!strcmp(argv[i], "--format") && i + 1 < argc) formatName = argv[++i];
+        else if (!strcmp(argv[i], "--fps") && i + 1 < argc) fps = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--from") && i + 1 < argc) from = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--to") && i + 1 < argc) to = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            sscanf(argv[++i], "%dx%d", &options.width, &options.height);
+            sizeGiven = true;
+        }
+        else if (!strcmp(argv[i], "--scroll") && i + 1 < argc) options.scrollY = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) options.threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--memory") && i + 1 < argc) options.memoryBudget = (size_t)strtoull(argv[++i], nullptr, 10) << 20;
+        else if (argv[i][0] != '-' && !tracePath) tracePath = argv[i];
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!outPath || fps <= 0 || (to && to < from) || !ParseFrameFormat(formatName, options.format)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    BuildingConfig config;
+    string error;
+    if (configPath && !LoadBuildingConfig(configPath, config, error)) {
+        fprintf(stderr, "Błąd konfiguracji: %s\n", error.c_str());
+        return 1;
+    }
+    if (carCount > 0) config.carCount = carCount;
+    if (!ValidateBuildingConfig(config, error)) {
+        fprintf(stderr, "Błąd konfiguracji: %s\n", error.c_str());
+        return 1;
+    }
+    if (options.width <= 0 || options.height <= 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    unique_ptr<TraceSource> source;
+    if (tracePath) {
+        source = OpenTrace(tracePath, error);
+        if (!source) {
+            fprintf(stderr, "Błąd pliku ruchu: %s\n", error.c_str());
+            return 1;
+        }
+    }
+    else if (trafficName) {
+        TrafficPattern pattern;
+        if (!ParseTrafficPattern(trafficName, pattern) || rate <= 0) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        source = make_unique<TrafficGenerator>(pattern, config.floorCount, rate, duration, seed);
+    }
+    else {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    unique_ptr<Dispatcher> dispatcher = CreateDispatcher(dispatcherName);
+    if (!dispatcher) {
+        fprintf(stderr, "Nieznany dyspozytor: %s\n", dispatcherName.c_str());
+        return 1;
+    }
+    ManualClock clock;
+    ElevatorBank bank(clock, config, move(dispatcher));
+    EventScheduler scheduler(bank, clock);
+    scheduler.SetArrivalSource(source.get());
+
+    // Bez --size klatka jest na tyle szeroka, żeby zmieściły się wszystkie kabiny; za wąska --size to błąd,
+    // a nie klatki z brakującymi kabinami.
+    int cars = (int)bank.cars.size();
+    if (!sizeGiven) options.width = max(options.width, FrameWidthForCars(cars));
+    if (!CarsFitFrame(options, cars, error)) {
+        fprintf(stderr, "Błąd eksportu: %s\n", error.c_str());
+        return 1;
+    }
+
+    bool toStdout = !strcmp(outPath, "-");
+#ifdef _WIN32
+    if (toStdout) _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    // Przy klatkach na standardowym wyjściu podsumowanie idzie na standardowe wyjście błędów.
+    FILE* report = toStdout ? stderr : stdout;
+
+    FrameExporter exporter(options);
+    size_t perFloor = exporter.PassengersPerFloor();
+    uint32_t lastTime = from;
+    // Klatka frame pokazuje stan z chwili from + frame / fps (zaokrąglonej w dół do kroku symulacji).
+    auto capture = [&](size_t frame, SceneState& state) {
+        uint32_t time = from + (uint32_t)((uint64_t)frame * 1000 / fps);
+        if (to && time > to) return false;
+        if (!to && frame > 0 && !scheduler.HasPendingArrivals() && bank.PassengersInSystem() == 0) return false;
+        scheduler.AdvanceTo(time);
+        CaptureScene(bank, perFloor, state);
+        lastTime = time;
+        return true;
+    };
+    auto write = [&](size_t frame, const vector<uint8_t>& data, string& message) {
+        if (toStdout) {
+            if (fwrite(data.data(), 1, data.size(), stdout) == data.size()) return true;
+            message = "zapis na standardowe wyjście";
+            return false;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "/frame_%06zu.%s", frame, FrameFormatName(options.format));
+        string path = string(outPath) + name;
+        FILE* file = fopen(path.c_str(), "wb");
+        bool written = file && fwrite(data.data(), 1, data.size(), file) == data.size();
+        if (file && fclose(file) != 0) written = false;
+        if (!written) message = "zapis " + path;
+        return written;
+    };
+
+    auto wallStart = chrono::steady_clock::now();
+    ExportStats stats;
+    if (!exporter.Run(capture, write, stats, error)) {
+        fprintf(stderr, "Błąd eksportu: %s\n", error.c_str());
+        return 1;
+    }
+    if (toStdout) fflush(stdout);
+    double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+    double simSeconds = (lastTime - from) / 1000.0;
+
+    fprintf(report, "Klatki:               %zu (%dx%d, %s, %d na sekundę)\n", stats.frames, options.width, options.height,
+        FrameFormatName(options.format), fps);
+    fprintf(report, "Czas symulowany:      %.1f s\n", simSeconds);
+    fprintf(report, "Czas rzeczywisty:     %.3f s\n", wallSeconds);
+    if (wallSeconds > 0) {
+        fprintf(report, "Przyspieszenie:       %.0fx\n", simSeconds / wallSeconds);
+        fprintf(report, "Klatki na sekundę:    %.0f\n", stats.frames / wallSeconds);
+    }
+    fprintf(report, "Zapisane dane:        %.1f MB (%.1f kB na klatkę)\n", stats.bytes / 1048576.0,
+        stats.frames ? stats.bytes / 1024.0 / stats.frames : 0.0);
+    return 0;
+}
@@ -0,0 +1,184 @@
+﻿#include "Scenario.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Dispatcher.h"
+
+using namespace std;
+
+ScenarioSession::ScenarioSession(const BuildingConfig& config, unique_ptr<Dispatcher> dispatcher)
+    : bank(clock, config, move(dispatcher)), scheduler(bank, clock) {}
+
+void ScenarioSession::Arrive(int startFloor, int targetFloor, int count, uint32_t time) {
+    scheduler.ScheduleArrival(max(time, Now()), startFloor, targetFloor, count);
+}
+
+void ScenarioSession::Step(uint32_t ticks) {
+    AdvanceTo(Now() + ticks * TICK_DURATION);
+}
+
+void ScenarioSession::AdvanceTo(uint32_t time) {
+    scheduler.AdvanceTo(time);
+    wallTarget = max(wallTarget, (double)Now());
+}
+
+void ScenarioSession::Resume() {
+    if (paused) wallTarget = Now();
+    paused = false;
+}
+
+void ScenarioSession::Elapse(double wallMs) {
+    if (paused || wallMs <= 0.0) return;
+    wallTarget += wallMs * speed;
+    scheduler.AdvanceTo((uint32_t)min(wallTarget, (double)UINT32_MAX));
+}
+
+bool ParseScenarioTime(const string& text, uint32_t& ms) {
+    char* end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    string unit = end;
+    double scale;
+    if (unit.empty() || unit == "ms") scale = 1.0;
+    else if (unit == "s") scale = 1000.0;
+    else if (unit == "min") scale = 60000.0;
+    else return false;
+    if (end == text.c_str() || value < 0.0 || value * scale > UINT32_MAX) return false;
+    ms = (uint32_t)(value * scale + 0.5);
+    return true;
+}
+
+static bool ParseCount(const string& text, long min, long max, long& value) {
+    char* end = nullptr;
+    value = strtol(text.c_str(), &end, 10);
+    return end != text.c_str() && *end == '\0' && value >= min && value <= max;
+}
+
+static const char* StateName(ElevatorState state) {
+    switch (state) {
+    case ElevatorState::IDLE: return "idle";
+    case ElevatorState::MOVING: return "moving";
+    case ElevatorState::STOPPED: return "stopped";
+    }
+    return "?";
+}
+
+static const char* DirectionName(Direction direction) {
+    switch (direction) {
+    case Direction::UP: return "up";
+    case Direction::DOWN: return "down";
+    case Direction::NONE: return "none";
+    }
+    return "?";
+}
+
+string ScenarioSession::Status() const {
+    size_t riding = 0;
+    for (const auto& car : bank.cars) riding += car.passengersInside + car.boardingPassengers;
+    char text[160];
+    snprintf(text, sizeof(text), "ok time=%u waiting=%zu riding=%zu delivered=%d paused=%d speed=%g",
+        Now(), bank.PassengersInSystem() - riding, riding, bank.deliveredPassengers, paused ? 1 : 0, speed);
+    return text;
+}
+
+string ScenarioSession::CarStatus(int index) const {
+    const BuildingConfig& config = bank.config;
+    const Elevator& car = bank.cars[index];
+    char text[160];
+    snprintf(text, sizeof(text), "ok car=%d state=%s floor=%d target=%d direction=%s inside=%d assigned=%d",
+        index, StateName(car.currentState), config.GroundFloor() - config.GetFloorFromY(car.elevatorY),
+        car.targetFloor == -1 ? -1 : config.GroundFloor() - car.targetFloor, DirectionName(car.currentDirection),
+        car.passengersInside, car.assignedPassengers);
+    return text;
+}
+
+string ScenarioSession::MetricsSummary() const {
+    const SimulationMetrics& metrics = bank.metrics;
+    char text[200];
+    snprintf(text, sizeof(text), "ok delivered=%d wait_mean=%.0f wait_p95=%u ride_mean=%.0f ride_p95=%u journey_mean=%.0f journey_p95=%u",
+        bank.deliveredPassengers, metrics.wait.Mean(), metrics.wait.Percentile(95), metrics.ride.Mean(),
+        metrics.ride.Percentile(95), metrics.journey.Mean(), metrics.journey.Percentile(95));
+    return text;
+}
+
+// Polecenia (czasy w ms, chyba że podano jednostkę):
+//   arrive N Z DO [at CZAS]   N osób z piętra Z na piętro DO, teraz albo w chwili CZAS
+//   step [N]                  N kroków (domyślnie 1)
+//   run CZAS / until CZAS     przesunięcie czasu o CZAS / do chwili CZAS
+//   pause, resume, speed X    czas rzeczywisty: zatrzymanie, wznowienie, mnożnik
+//   status, car I, metrics    stan budynku, kabiny I i czasy podróży (ms)
+//   quit
+bool ScenarioSession::Execute(const string& line, string& reply) {
+    reply.clear();
+    vector<string> words;
+    size_t pos = 0;
+    while (true) {
+        pos = line.find_first_not_of(" \t\r\n", pos);
+        if (pos == string::npos || line[pos] == '#') break;
+        size_t end = line.find_first_of(" \t\r\n", pos);
+        words.push_back(line.substr(pos, end - pos));
+        pos = end;
+    }
+    if (words.empty()) return true;
+
+    const BuildingConfig& config = bank.config;
+    const string& command = words[0];
+    size_t args = words.size() - 1;
+    long a, b, c;
+    uint32_t time;
+    if (command == "arrive" && (args == 3 || (args == 5 && words[4] == "at"))) {
+        if (!ParseCount(words[1], 1, 1000000, a)) reply = "error liczba osób musi być od 1 do 1000000";
+        else if (!ParseCount(words[2], 0, config.floorCount - 1, b) || !ParseCount(words[3], 0, config.floorCount - 1, c))
+            reply = "error piętro poza budynkiem";
+        else if (b == c) reply = "error piętro startowe i docelowe są takie same";
+        else if (args == 5 && !ParseScenarioTime(words[5], time)) reply = "error błędny czas '" + words[5] + "'";
+        else {
+            Arrive(config.FloorFromLabel((int)b), config.FloorFromLabel((int)c), (int)a, args == 5 ? time : Now());
+            reply = "ok";
+        }
+    }
+    else if (command == "step" && args <= 1) {
+        if (args == 1 && !ParseCount(words[1], 0, UINT32_MAX / TICK_DURATION, a)) reply = "error błędna liczba kroków";
+        else {
+            Step(args == 1 ? (uint32_t)a : 1);
+            reply = "ok time=" + to_string(Now());
+        }
+    }
+    else if ((command == "run" || command == "until") && args == 1) {
+        if (!ParseScenarioTime(words[1], time)) reply = "error błędny czas '" + words[1] + "'";
+        else {
+            AdvanceTo(command == "run" ? Now() + time : time);
+            reply = "ok time=" + to_string(Now());
+        }
+    }
+    else if (command == "pause" && args == 0) {
+        Pause();
+        reply = "ok time=" + to_string(Now());
+    }
+    else if (command == "resume" && args == 0) {
+        Resume();
+        reply = "ok time=" + to_string(Now());
+    }
+    else if (command == "speed" && args == 1) {
+        double value = atof(words[1].c_str());
+        if (value <= 0.0) reply = "error mnożnik musi być > 0";
+        else {
+            SetSpeed(value);
+            reply = "ok";
+        }
+    }
+    else if (command == "status" && args == 0) reply = Status();
+    else if (command == "car" && args == 1) {
+        if (!ParseCount(words[1], 0, (long)bank.cars.size() - 1, a)) reply = "error nie ma kabiny '" + words[1] + "'";
+        else reply = CarStatus((int)a);
+    }
+    else if (command == "metrics" && args == 0) reply = MetricsSummary();
+    else if (command == "quit" && args == 0) {
+        reply = "ok";
+        return false;
+    }
+    else reply = "error nieznane polecenie albo złe argumenty: " + command;
+    return true;
+}
@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "EventScheduler.h"
+#include "Simulation.h"
+
+class Dispatcher;
+
+// Symulacja sterowana z zewnątrz: programowo (Arrive, Step, AdvanceTo) albo poleceniami tekstowymi (Execute).
+// Czas stoi, dopóki nie przesunie go Step/AdvanceTo; po Resume dodatkowo biegnie z czasem rzeczywistym
+// pomnożonym przez Speed(), odmierzanym przez Elapse. Kroki wykonuje EventScheduler, więc wynik jest taki
+// sam jak w pętli krokowej. Piętra w API to indeksy jak w ElevatorBank, w poleceniach etykiety (0 = parter).
+class ScenarioSession {
+public:
+    explicit ScenarioSession(const BuildingConfig& config, std::unique_ptr<Dispatcher> dispatcher = nullptr);
+
+    // count osób z jednego wezwania przychodzi w chwili time (nie wcześniej niż przed następnym krokiem).
+    void Arrive(int startFloor, int targetFloor, int count, uint32_t time);
+    void Arrive(int startFloor, int targetFloor, int count) { Arrive(startFloor, targetFloor, count, Now()); }
+    void Step(uint32_t ticks);
+    void AdvanceTo(uint32_t time);
+
+    void Pause() { paused = true; }
+    void Resume();
+    bool Paused() const { return paused; }
+    void SetSpeed(double speed) { this->speed = speed; }
+    double Speed() const { return speed; }
+    // Upłynęło wallMs ms czasu rzeczywistego; bez Resume nic nie robi.
+    void Elapse(double wallMs);
+
+    uint32_t Now() const { return clock.Now(); }
+    const ElevatorBank& Bank() const { return bank; }
+
+    // Wykonuje jedną linię protokołu. reply to jedna linia odpowiedzi bez końca linii ("ok ..." albo
+    // "error ..."), pusta dla linii pustych i komentarzy (#). Zwraca false po poleceniu quit.
+    bool Execute(const std::string& line, std::string& reply);
+
+private:
+    std::string Status() const;
+    std::string CarStatus(int index) const;
+    std::string MetricsSummary() const;
+
+    ManualClock clock;
+    ElevatorBank bank;
+    EventScheduler scheduler;
+    bool paused = true;
+    double speed = 1.0;
+    // Czas symulowany, do którego trzeba dojść w trybie ciągłym; część ułamkowa przechodzi na kolejne Elapse.
+    double wallTarget = 0.0;
+};
+
+// Czas w poleceniach: "120s", "1500ms", "2.5min" albo liczba milisekund. Zwraca false przy błędnym zapisie.
+bool ParseScenarioTime(const std::string& text, uint32_t& ms);
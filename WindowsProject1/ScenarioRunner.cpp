@@ -0,0 +1,167 @@
+﻿#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "Dispatcher.h"
+#include "Scenario.h"
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+void PrintUsage(const char* name) {
+    fprintf(stderr,
+        "Użycie: %s [--config plik] [--cars N] [--dispatcher nearest|eta|destination] [--socket ścieżka]\n"
+        "  Polecenia po jednym w linii ze standardowego wejścia albo z gniazda UNIX (--socket), odpowiedź\n"
+        "  \"ok ...\" albo \"error ...\" w jednej linii. Piętra jak w plikach ruchu (0 = parter), czasy w ms\n"
+        "  albo z jednostką s/min:\n"
+        "    arrive N Z DO [at CZAS]   N osób z jednego wezwania\n"
+        "    step [N], run CZAS, until CZAS\n"
+        "    pause, resume, speed X    po resume czas biegnie z czasem rzeczywistym razy X\n"
+        "    status, car I, metrics, quit\n",
+        name);
+}
+
+// Czas rzeczywisty od poprzedniego wywołania Lap, w ms.
+class WallTimer {
+public:
+    double Lap() {
+        auto now = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(now - last).count();
+        last = now;
+        return ms;
+    }
+
+private:
+    chrono::steady_clock::time_point last = chrono::steady_clock::now();
+};
+
+// Odpowiedzi są wysyłane, gdy w buforze wejścia nie ma już kolejnych poleceń, więc skrypt przepuszczony
+// potokiem nie czeka na opróżnianie wyjścia po każdej linii.
+int ServeStream(ScenarioSession& session) {
+    ios::sync_with_stdio(false);
+    WallTimer timer;
+    string line, reply;
+    while (getline(cin, line)) {
+        session.Elapse(timer.Lap());
+        bool more = session.Execute(line, reply);
+        if (!reply.empty()) {
+            fwrite(reply.data(), 1, reply.size(), stdout);
+            fputc('\n', stdout);
+        }
+        if (!more) break;
+        if (cin.rdbuf()->in_avail() <= 0) fflush(stdout);
+    }
+    fflush(stdout);
+    return 0;
+}
+
+#ifndef _WIN32
+bool WriteAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = write(fd, data.data() + sent, data.size() - sent);
+        if (n <= 0) return false;
+        sent += (size_t)n;
+    }
+    return true;
+}
+
+// Klienci są obsługiwani po kolei i działają na tej samej symulacji; quit kończy program.
+int ServeSocket(ScenarioSession& session, const char* path) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Za długa ścieżka gniazda: %s\n", path);
+        return 1;
+    }
+    strcpy(address.sun_path, path);
+    signal(SIGPIPE, SIG_IGN);
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (server < 0 || bind(server, (sockaddr*)&address, sizeof(address)) != 0 || listen(server, 4) != 0) {
+        fprintf(stderr, "Nie można nasłuchiwać na %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    fprintf(stderr, "Nasłuch na %s\n", path);
+
+    WallTimer timer;
+    bool running = true;
+    char buffer[65536];
+    while (running) {
+        int client = accept(server, nullptr, nullptr);
+        if (client < 0) break;
+        string pending, out, reply;
+        ssize_t got;
+        while (running && (got = read(client, buffer, sizeof(buffer))) > 0) {
+            pending.append(buffer, (size_t)got);
+            size_t start = 0, end;
+            while (running && (end = pending.find('\n', start)) != string::npos) {
+                session.Elapse(timer.Lap());
+                running = session.Execute(pending.substr(start, end - start), reply);
+                if (!reply.empty()) out += reply + '\n';
+                start = end + 1;
+            }
+            pending.erase(0, start);
+            if (!WriteAll(client, out)) break;
+            out.clear();
+        }
+        close(client);
+    }
+    close(server);
+    unlink(path);
+    return 0;
+}
+#endif
+
+int main(int argc, char** argv) {
+    const char* configPath = nullptr;
+    const char* socketPath = nullptr;
+    string dispatcherName = "nearest";
+    int carCount = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--config") && i + 1 < argc) configPath = argv[++i];
+        else if (!strcmp(argv[i], "--cars") && i + 1 < argc) carCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--dispatcher") && i + 1 < argc) dispatcherName = argv[++i];
+        else if (!strcmp(argv[i], "--socket") && i + 1 < argc) socketPath = argv[++i];
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    BuildingConfig config;
+    string error;
+    if (configPath && !LoadBuildingConfig(configPath, config, error)) {
+        fprintf(stderr, "Błąd konfiguracji: %s\n", error.c_str());
+        return 1;
+    }
+    if (carCount > 0) config.carCount = carCount;
+    unique_ptr<Dispatcher> dispatcher = CreateDispatcher(dispatcherName);
+    if (!dispatcher) {
+        fprintf(stderr, "Nieznany dyspozytor: %s\n", dispatcherName.c_str());
+        return 1;
+    }
+
+    ScenarioSession session(config, move(dispatcher));
+    if (socketPath) {
+#ifndef _WIN32
+        return ServeSocket(session, socketPath);
+#else
+        fprintf(stderr, "Gniazda UNIX nie są dostępne w tym systemie\n");
+        return 1;
+#endif
+    }
+    return ServeStream(session);
+}
@@ -0,0 +1,339 @@
+﻿#include "Scene.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+const Argb COLOR_WHITE = MakeArgb(255, 255, 255);
+const Argb COLOR_BLACK = MakeArgb(0, 0, 0);
+const Argb COLOR_WALL = MakeArgb(220, 220, 220);
+const Argb COLOR_FLOOR = MakeArgb(169, 169, 169);
+const Argb COLOR_DOOR = MakeArgb(47, 79, 79);
+const Argb COLOR_CAR_TOP = MakeArgb(200, 200, 200);
+const Argb COLOR_CAR_BOTTOM = MakeArgb(150, 150, 150);
+const Argb COLOR_RIDER_HEAD = MakeArgb(0, 0, 255);
+const Argb COLOR_RIDER_BODY = MakeArgb(0, 0, 139);
+const Argb COLOR_WAITING_HEAD = MakeArgb(0, 128, 0);
+const Argb COLOR_WAITING_BODY = MakeArgb(0, 100, 0);
+
+const int FLOOR_LABEL_SIZE = 14;
+const int TARGET_LABEL_SIZE = 10;
+const int RIDER_LABEL_SIZE = 8;
+const int INFO_SIZE = 12;
+
+// Ramka etykiety z zapasem: znak nie jest szerszy od rozmiaru czcionki, a wiersz od dwóch rozmiarów.
+static ScreenRect LabelBounds(int x, int y, size_t chars, int size) {
+    return { x, y, (int)chars * size, size * 2 };
+}
+
+static int Digits(int value) {
+    int digits = value < 0 ? 2 : 1;
+    for (value = abs(value); value >= 10; value /= 10) digits++;
+    return digits;
+}
+
+static void DrawStickFigure(RenderBackend& r, int x, int y, Argb headColor, Argb bodyColor) {
+    ScreenRect head = { x, y, PASSENGER_HEAD_RADIUS * 2, PASSENGER_HEAD_RADIUS * 2 };
+    r.FillEllipse(head, headColor);
+    r.DrawEllipse(head, bodyColor, 2);
+    int headCenterX = x + PASSENGER_HEAD_RADIUS;
+    int bodyTopY = y + PASSENGER_HEAD_RADIUS * 2;
+    int bodyBottomY = bodyTopY + PASSENGER_BODY_HEIGHT;
+    r.DrawLine(headCenterX, bodyTopY, headCenterX, bodyBottomY, bodyColor, 2);
+    r.DrawLine(headCenterX - PASSENGER_ARM_SPAN / 2, bodyTopY + PASSENGER_BODY_HEIGHT / 2, headCenterX + PASSENGER_ARM_SPAN / 2, bodyTopY + PASSENGER_BODY_HEIGHT / 2, bodyColor, 2);
+    r.DrawLine(headCenterX, bodyBottomY, headCenterX - PASSENGER_LEG_LENGTH / 2, bodyBottomY + PASSENGER_LEG_LENGTH, bodyColor, 2);
+    r.DrawLine(headCenterX, bodyBottomY, headCenterX + PASSENGER_LEG_LENGTH / 2, bodyBottomY + PASSENGER_LEG_LENGTH, bodyColor, 2);
+}
+
+static ScreenRect FigureBounds(int x, int y) {
+    return { x - 2, y - 2, PASSENGER_TOTAL_WIDTH + 4, PASSENGER_TOTAL_HEIGHT + 4 };
+}
+
+void SceneRenderer::SetViewport(int width, int height, int scrollY) {
+    if (width == this->width && height == this->height && scrollY == this->scrollY) return;
+    this->width = width;
+    this->height = height;
+    this->scrollY = scrollY;
+    backgroundDirty = true;
+}
+
+void SceneRenderer::SetInfoText(const wstring& text) {
+    infoText = text;
+    backgroundDirty = true;
+}
+
+static PassengerView View(const Passenger& p) {
+    return { p.id, p.car, p.startFloor, p.targetFloor, p.posIndex, p.inElevator, p.boarding, p.animX, p.animY };
+}
+
+void CaptureScene(const ElevatorBank& bank, size_t perFloor, SceneState& state) {
+    state.config = &bank.config;
+    state.time = bank.clock.Now();
+    state.cars.clear();
+    state.riders.clear();
+    state.waiting.clear();
+    state.floorStart.clear();
+    // Pojemność na największy możliwy stan, więc publikowanie stanu co krok nie przydziela pamięci, dopóki
+    // nie urośnie pula pasażerów.
+    size_t seats = 0;
+    for (const auto& car : bank.cars) seats += car.occupants.capacity();
+    state.cars.reserve(bank.cars.size());
+    state.riders.reserve(seats);
+    state.waiting.reserve(min(perFloor * bank.lobbies.size(), bank.passengers.capacity()));
+    state.floorStart.reserve(bank.lobbies.size() + 1);
+    for (const auto& car : bank.cars) {
+        state.cars.push_back({ car.elevatorY, car.passengersInside });
+        for (int slot : car.occupants) state.riders.push_back(View(bank.passengers[slot]));
+    }
+    for (const auto& lobby : bank.lobbies) {
+        state.floorStart.push_back((int)state.waiting.size());
+        size_t taken = 0;
+        for (int slot = lobby.head; slot != -1 && taken < perFloor; slot = bank.passengers[slot].lobbyNext, ++taken) {
+            state.waiting.push_back(View(bank.passengers[slot]));
+        }
+    }
+    state.floorStart.push_back((int)state.waiting.size());
+}
+
+void InterpolateScene(const SceneState& from, const SceneState& to, float t, SceneState& out) {
+    out = to;
+    for (size_t i = 0; i < out.cars.size() && i < from.cars.size(); ++i) {
+        out.cars[i].elevatorY = from.cars[i].elevatorY + (to.cars[i].elevatorY - from.cars[i].elevatorY) * t;
+    }
+    for (auto& p : out.riders) {
+        if (!p.boarding) continue;
+        for (const auto& old : from.riders) {
+            if (old.id != p.id || !old.boarding) continue;
+            p.animX = old.animX + (p.animX - old.animX) * t;
+            p.animY = old.animY + (p.animY - old.animY) * t;
+            break;
+        }
+    }
+}
+
+// Nowy stan zaczyna się od tego, co było właśnie pokazane, więc ruch nie przeskakuje.
+void SceneInterpolator::Receive(const SceneState& state, double now) {
+    if (received == 0) {
+        to = state;
+        frame = state;
+    }
+    else {
+        double gap = now - receivedAt;
+        interval = received == 1 ? gap : 0.8 * interval + 0.2 * gap;
+    }
+    from = frame;
+    to = state;
+    receivedAt = now;
+    received++;
+}
+
+const SceneState& SceneInterpolator::Frame(double now) {
+    float t = 1.0f;
+    if (interval > 0.0) t = (float)min(1.0, max(0.0, (now - receivedAt) / interval));
+    InterpolateScene(from, to, t, frame);
+    return frame;
+}
+
+size_t SceneRenderer::PassengersPerFloor() const {
+    return (size_t)max(0, width / (PASSENGER_TOTAL_WIDTH + PASSENGER_SPACING)) + 1;
+}
+
+void SceneRenderer::AddPassenger(const SceneState& state, const PassengerView& p) {
+    const BuildingConfig& config = *state.config;
+    Sprite s;
+    s.key = p.id;
+    s.label = config.GroundFloor() - p.targetFloor;
+    if (p.inElevator) {
+        int elevatorX = GetElevatorScreenX(p.car);
+        int elevatorScreenY = (int)state.cars[p.car].elevatorY + config.floorHeight - ELEVATOR_HEIGHT - scrollY;
+        s.kind = SpriteKind::RIDER;
+        s.x = elevatorX + p.posIndex * (PASSENGER_TOTAL_WIDTH + PASSENGER_SPACING);
+        s.y = elevatorScreenY + ELEVATOR_HEIGHT - PASSENGER_TOTAL_HEIGHT;
+        if (s.x + PASSENGER_TOTAL_WIDTH > elevatorX + ELEVATOR_WIDTH) return;
+        s.bounds = Union(FigureBounds(s.x, s.y), LabelBounds(s.x + PASSENGER_HEAD_RADIUS - 5, s.y - 10, Digits(s.label), RIDER_LABEL_SIZE));
+    }
+    else {
+        if (p.boarding) {
+            s.kind = SpriteKind::BOARDING;
+            s.x = (int)p.animX;
+            s.y = (int)p.animY - scrollY;
+        }
+        else {
+            s.kind = SpriteKind::WAITING;
+            s.x = UI_WALL_START_X + 20 + p.posIndex * (PASSENGER_TOTAL_WIDTH + PASSENGER_SPACING);
+            s.y = p.startFloor * config.floorHeight + (config.floorHeight - PASSENGER_TOTAL_HEIGHT) - scrollY;
+        }
+        s.bounds = Union(FigureBounds(s.x, s.y), LabelBounds(s.x + PASSENGER_TOTAL_WIDTH, s.y + PASSENGER_HEAD_RADIUS, 3 + Digits(s.label), TARGET_LABEL_SIZE));
+    }
+    if (Overlaps(s.bounds, { 0, 0, width, height })) current.push_back(s);
+}
+
+// Tylko kabiny, pasażerowie w kabinach i na widocznych piętrach, do szerokości okna.
+void SceneRenderer::BuildSprites(const SceneState& state) {
+    const BuildingConfig& config = *state.config;
+    current.clear();
+    for (size_t i = 0; i < state.cars.size(); ++i) {
+        Sprite s;
+        s.kind = SpriteKind::CAR;
+        s.key = (int)i;
+        s.x = GetElevatorScreenX((int)i);
+        s.y = (int)state.cars[i].elevatorY + config.floorHeight - ELEVATOR_HEIGHT - scrollY;
+        s.label = 0;
+        s.bounds = { s.x - 2, s.y - 2, ELEVATOR_WIDTH + 4, ELEVATOR_HEIGHT + 4 };
+        if (Overlaps(s.bounds, { 0, 0, width, height })) current.push_back(s);
+    }
+    for (const auto& p : state.riders) AddPassenger(state, p);
+    size_t perFloor = PassengersPerFloor();
+    int firstFloor = max(0, scrollY / config.floorHeight);
+    int lastFloor = min(config.floorCount - 1, (scrollY + height) / config.floorHeight);
+    for (int floor = firstFloor; floor <= lastFloor && floor + 1 < (int)state.floorStart.size(); ++floor) {
+        int end = min(state.floorStart[floor + 1], state.floorStart[floor] + (int)perFloor);
+        for (int i = state.floorStart[floor]; i < end; ++i) AddPassenger(state, state.waiting[i]);
+    }
+    sort(current.begin(), current.end(), [](const Sprite& a, const Sprite& b) { return a.SortKey() < b.SortKey(); });
+}
+
+void SceneRenderer::DrawBackground(const BuildingConfig& config) {
+    backend.ResetClip();
+    backend.FillRectangle({ 0, 0, width, height }, COLOR_WHITE);
+    int firstFloor = max(0, scrollY / config.floorHeight);
+    int lastFloor = min(config.floorCount - 1, (scrollY + height) / config.floorHeight);
+    int wallEndX = GetWallEndX(config.carCount);
+    for (int i = firstFloor; i <= lastFloor; i++) {
+        int y = i * config.floorHeight - scrollY;
+        backend.FillRectangle({ UI_WALL_START_X, y, wallEndX - UI_WALL_START_X, config.floorHeight }, COLOR_WALL);
+        backend.DrawLine(UI_WALL_START_X, y, wallEndX, y, COLOR_FLOOR, 2);
+        backend.DrawLabel(10, y + 30, L"Piętro " + to_wstring(config.GroundFloor() - i), FLOOR_LABEL_SIZE, COLOR_BLACK);
+    }
+    int bottom = config.floorCount * config.floorHeight - scrollY;
+    backend.DrawLine(UI_WALL_START_X, bottom, wallEndX, bottom, COLOR_FLOOR, 2);
+    backend.DrawLabel(10, bottom + 35, infoText, INFO_SIZE, COLOR_BLACK);
+}
+
+void SceneRenderer::DrawSprite(const Sprite& s) {
+    switch (s.kind) {
+    case SpriteKind::CAR: {
+        ScreenRect car = { s.x, s.y, ELEVATOR_WIDTH, ELEVATOR_HEIGHT };
+        backend.FillGradient(car, COLOR_CAR_TOP, COLOR_CAR_BOTTOM);
+        backend.DrawRectangle(car, COLOR_BLACK, 3);
+        backend.DrawLine(s.x + ELEVATOR_WIDTH / 2, s.y, s.x + ELEVATOR_WIDTH / 2, s.y + ELEVATOR_HEIGHT, COLOR_DOOR, 2);
+        break;
+    }
+    case SpriteKind::RIDER:
+        DrawStickFigure(backend, s.x, s.y, COLOR_RIDER_HEAD, COLOR_RIDER_BODY);
+        backend.DrawLabel(s.x + PASSENGER_HEAD_RADIUS - 5, s.y - 10, to_wstring(s.label), RIDER_LABEL_SIZE, COLOR_WHITE);
+        break;
+    case SpriteKind::BOARDING:
+    case SpriteKind::WAITING:
+        DrawStickFigure(backend, s.x, s.y, COLOR_WAITING_HEAD, COLOR_WAITING_BODY);
+        backend.DrawLabel(s.x + PASSENGER_TOTAL_WIDTH, s.y + PASSENGER_HEAD_RADIUS, L"-> " + to_wstring(s.label), TARGET_LABEL_SIZE, COLOR_BLACK);
+        break;
+    }
+}
+
+wstring SceneRenderer::StatusText(const SceneState& state) const {
+    wstring weights;
+    for (size_t i = 0; i < state.cars.size(); ++i) {
+        if (i > 0) weights += L" / ";
+        weights += to_wstring((int)(state.cars[i].passengersInside * state.config->weightPerPerson));
+    }
+    wstring text = L"Aktualna masa: " + weights + L" kg (Max: " + to_wstring((int)state.config->maxWeight) + L" kg)";
+    if (state.speed != 1.0) text += L"  Czas x" + to_wstring((int)state.speed);
+    return text;
+}
+
+ScreenRect SceneRenderer::StatusBounds() const {
+    return LabelBounds(10, statusY, max(status.size(), (size_t)1), INFO_SIZE);
+}
+
+void SceneRenderer::DrawStatus() {
+    backend.DrawLabel(10, statusY, status, INFO_SIZE, COLOR_BLACK);
+}
+
+void SceneRenderer::AddDirty(const ScreenRect& rect) {
+    ScreenRect r = Intersect(rect, { 0, 0, width, height });
+    if (!r.Empty()) dirty.push_back(r);
+}
+
+// Nachodzące na siebie prostokąty są łączone. Przy zbyt wielu zostaje jeden obejmujący wszystkie.
+void SceneRenderer::MergeDirty() {
+    auto collapse = [&] {
+        ScreenRect all;
+        for (const auto& r : dirty) all = Union(all, r);
+        dirty.assign(1, all);
+    };
+    if (dirty.size() > 4 * MAX_DIRTY_RECTS) collapse();
+    for (bool merged = true; merged;) {
+        merged = false;
+        for (size_t i = 0; i < dirty.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < dirty.size(); ++j) {
+                if (Overlaps(dirty[i], dirty[j])) {
+                    dirty[i] = Union(dirty[i], dirty[j]);
+                    dirty.erase(dirty.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+    if (dirty.size() > MAX_DIRTY_RECTS) collapse();
+}
+
+const vector<ScreenRect>& SceneRenderer::Render(const SceneState& state) {
+    const BuildingConfig& config = *state.config;
+    BuildSprites(state);
+    wstring newStatus = StatusText(state);
+    dirty.clear();
+
+    if (backgroundDirty) {
+        backend.BeginBackground();
+        DrawBackground(config);
+        backend.EndBackground();
+        backgroundDirty = false;
+        statusY = config.floorCount * config.floorHeight + 10 - scrollY;
+        AddDirty({ 0, 0, width, height });
+    }
+    else if (fullRedraw) {
+        AddDirty({ 0, 0, width, height });
+    }
+    else {
+        // Obie listy są posortowane według SortKey, więc wystarczy jedno przejście.
+        size_t i = 0, j = 0;
+        while (i < previous.size() || j < current.size()) {
+            if (j == current.size() || (i < previous.size() && previous[i].SortKey() < current[j].SortKey())) {
+                AddDirty(previous[i++].bounds);
+            }
+            else if (i == previous.size() || current[j].SortKey() < previous[i].SortKey()) {
+                AddDirty(current[j++].bounds);
+            }
+            else {
+                if (!previous[i].SameAs(current[j])) {
+                    AddDirty(previous[i].bounds);
+                    AddDirty(current[j].bounds);
+                }
+                i++;
+                j++;
+            }
+        }
+        if (newStatus != status) {
+            AddDirty(StatusBounds());
+            AddDirty(LabelBounds(10, statusY, newStatus.size(), INFO_SIZE));
+        }
+        MergeDirty();
+    }
+    status = newStatus;
+
+    for (const auto& rect : dirty) {
+        backend.RestoreBackground(rect);
+        backend.SetClip(rect);
+        for (const auto& s : current) {
+            if (Overlaps(s.bounds, rect)) DrawSprite(s);
+        }
+        if (Overlaps(StatusBounds(), rect)) DrawStatus();
+    }
+    backend.ResetClip();
+    backend.EndFrame();
+    previous.swap(current);
+    return dirty;
+}
@@ -0,0 +1,131 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "Simulation.h"
+
+enum class SpriteKind : uint8_t {
+    CAR,
+    RIDER,
+    BOARDING,
+    WAITING
+};
+
+// Stan potrzebny do narysowania klatki, kopiowany ze stanu symulacji. Pozwala rysować w innym wątku
+// niż symulacja i interpolować położenia między dwoma stanami.
+struct CarView {
+    float elevatorY;
+    int passengersInside;
+};
+
+struct PassengerView {
+    int id;
+    int car;
+    int startFloor;
+    int targetFloor;
+    int posIndex;
+    bool inElevator;
+    bool boarding;
+    float animX;
+    float animY;
+};
+
+struct SceneState {
+    // Konfiguracja banku, z którego pochodzi stan. Jest niezmienna przez cały przebieg, więc stan niesie tylko
+    // wskaźnik, a publikacja kopiuje wyłącznie to, co zmienia się z krokiem. Bank musi żyć dłużej niż stan.
+    const BuildingConfig* config = nullptr;
+    uint32_t time = 0;
+    double speed = 1.0;
+    std::vector<CarView> cars;
+    // Pasażerowie w kabinach i wsiadający, w kolejności miejsc w kabinach.
+    std::vector<PassengerView> riders;
+    // Czekający, piętrami: piętro f to waiting[floorStart[f]] .. waiting[floorStart[f + 1] - 1].
+    std::vector<PassengerView> waiting;
+    std::vector<int> floorStart;
+};
+
+// Kopiuje co najwyżej perFloor czekających z każdego piętra. Wektory w state są używane ponownie.
+void CaptureScene(const ElevatorBank& bank, size_t perFloor, SceneState& state);
+// Położenia kabin i wsiadających między from (t = 0) i to (t = 1); reszta jak w to.
+void InterpolateScene(const SceneState& from, const SceneState& to, float t, SceneState& out);
+
+// Wygładza ruch, gdy stany przychodzą rzadziej niż klatki: klatka pokazuje stan między dwoma ostatnimi
+// otrzymanymi, przesuwając się od starszego do nowszego w czasie, jaki upłynął między ich nadejściem.
+class SceneInterpolator {
+public:
+    void Receive(const SceneState& state, double now);
+    const SceneState& Frame(double now);
+    bool HasState() const { return received > 0; }
+
+private:
+    SceneState from;
+    SceneState to;
+    SceneState frame;
+    double receivedAt = 0.0;
+    double interval = 0.0;
+    int received = 0;
+};
+
+// Ruchomy element sceny: kabina (key = numer kabiny) albo pasażer (key = id).
+struct Sprite {
+    SpriteKind kind;
+    int key;
+    int x;
+    int y;
+    int label;
+    ScreenRect bounds;
+
+    uint64_t SortKey() const { return ((uint64_t)kind << 32) | (uint32_t)key; }
+    bool SameAs(const Sprite& other) const { return x == other.x && y == other.y && label == other.label; }
+};
+
+// Scena w trybie zachowanym. Budynek (ściany, podłogi, opisy pięter) jest rysowany raz do warstwy tła,
+// a przy każdej klatce porównywane są listy elementów z poprzedniej i bieżącej klatki. Przerysowywane są
+// tylko prostokąty elementów, które się zmieniły: tło w tym miejscu i wszystkie elementy, które je przecinają.
+class SceneRenderer {
+public:
+    static const int MAX_DIRTY_RECTS = 16;
+
+    explicit SceneRenderer(RenderBackend& backend) : backend(backend) {}
+
+    // Zmiana rozmiaru albo przewinięcia wymusza narysowanie tła i całej klatki.
+    void SetViewport(int width, int height, int scrollY);
+    void SetInfoText(const std::wstring& text);
+    void InvalidateAll() { backgroundDirty = true; }
+    // Przy fullRedraw każda klatka jest rysowana w całości (do porównania kosztu).
+    void SetFullRedraw(bool fullRedraw) { this->fullRedraw = fullRedraw; }
+
+    // Rysuje klatkę i zwraca prostokąty, które trzeba przenieść na ekran.
+    const std::vector<ScreenRect>& Render(const SceneState& state);
+    size_t SpriteCount() const { return previous.size(); }
+    // Więcej czekających na jednym piętrze nie mieści się w oknie.
+    size_t PassengersPerFloor() const;
+
+private:
+    void BuildSprites(const SceneState& state);
+    void AddPassenger(const SceneState& state, const PassengerView& p);
+    void DrawBackground(const BuildingConfig& config);
+    void DrawSprite(const Sprite& sprite);
+    void DrawStatus();
+    void AddDirty(const ScreenRect& rect);
+    void MergeDirty();
+    std::wstring StatusText(const SceneState& state) const;
+    ScreenRect StatusBounds() const;
+
+    RenderBackend& backend;
+    int width = 0;
+    int height = 0;
+    int scrollY = 0;
+    int statusY = 0;
+    std::wstring infoText;
+    std::wstring status;
+    bool backgroundDirty = true;
+    bool fullRedraw = false;
+
+    std::vector<Sprite> previous;
+    std::vector<Sprite> current;
+    std::vector<ScreenRect> dirty;
+};
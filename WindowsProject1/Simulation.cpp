@@ -0,0 +1,793 @@
+﻿#include "Simulation.h"
+
+#include "Dispatcher.h"
+#include "EventLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+int GetElevatorScreenX(int carIndex) {
+    return ELEVATOR_SHAFT_X + carIndex * (ELEVATOR_WIDTH + ELEVATOR_SPACING);
+}
+
+int GetWallEndX(int carCount) {
+    return max(UI_WALL_START_X + UI_WALL_WIDTH, GetElevatorScreenX(max(1, carCount) - 1) + ELEVATOR_WIDTH + ELEVATOR_WALL_MARGIN);
+}
+
+template <class Building>
+BasicElevatorBank<Building>::BasicElevatorBank(const Clock& clock, const BuildingConfig& config, unique_ptr<Dispatcher> dispatcher)
+    : clock(clock), config(config), dispatcher(move(dispatcher)) {
+    int carCount = max(1, config.carCount);
+    cars.resize(carCount);
+    size_t seats = 0;
+    for (int i = 0; i < carCount; ++i) {
+        Car& car = cars[i];
+        car.index = i;
+        car.served.Resize(FloorCount());
+        for (int z = 0; z < (int)config.zones.size(); ++z) {
+            const CarZone& zone = config.zones[z];
+            if (i < zone.firstCar || i > zone.lastCar) continue;
+            car.zone = z;
+            car.decks = zone.doubleDeck ? 2 : 1;
+            for (int label : zone.floors) {
+                if (label < FloorCount()) car.served.Set(GroundFloor() - label);
+            }
+        }
+        if (car.zone == -1) {
+            for (int floor = 0; floor < FloorCount(); ++floor) car.served.Set(floor);
+        }
+        car.homeFloor = StopFloor(car, car.served.LastUpTo(GroundFloor()));
+        car.elevatorY = (float)car.homeFloor * FloorHeight();
+        car.destinations.Resize(FloorCount());
+        car.upRequests.Resize(FloorCount());
+        car.downRequests.Resize(FloorCount());
+        car.waitingUp.Resize(FloorCount());
+        car.waitingDown.Resize(FloorCount());
+        car.queueUp.resize(FloorCount());
+        car.queueDown.resize(FloorCount());
+        car.riders.resize(FloorCount());
+        car.occupants.reserve(CarCapacity() * car.decks);
+        seats += CarCapacity() * car.decks;
+    }
+    boardingBatch.Reserve(seats);
+    lobbies.resize(FloorCount());
+    metrics.cars.resize(carCount);
+    for (auto& car : cars) {
+        metrics.cars[car.index].lastStopFloor = car.homeFloor;
+        metrics.cars[car.index].decks = car.decks;
+    }
+    if (!config.zones.empty()) routes = ZoneRoutes(FloorCount(), carCount, config.zones);
+    if (Building::Parking(config) == ParkingPolicy::DEMAND) demand = DemandModel(FloorCount(), config.demandSlot, config.demandHalfLife);
+    LOG_EVENT(RUN, clock.Now(), 0, FloorCount(), carCount);
+    if (!this->dispatcher) this->dispatcher = make_unique<NearestCarDispatcher>();
+}
+
+template <class Building>
+BasicElevatorBank<Building>::~BasicElevatorBank() = default;
+
+template <class Building>
+void BasicElevatorBank<Building>::Reserve(size_t passengerCount) {
+    passengers.reserve(passengerCount);
+    if (config.patience > 0) patienceTimers.reserve(passengerCount);
+}
+
+// Zwolnione miejsca są używane od ostatnio zwolnionego.
+template <class Building>
+int BasicElevatorBank<Building>::AllocateSlot() {
+    if (freeHead == -1) {
+        passengers.emplace_back();
+        return (int)passengers.size() - 1;
+    }
+    int slot = freeHead;
+    freeHead = passengers[slot].next;
+    freeCount--;
+    return slot;
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::FreeSlot(int slot) {
+    passengers[slot].next = freeHead;
+    freeHead = slot;
+    freeCount++;
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::AddPassenger(int startFloor, int targetFloor) {
+    AddPassenger(startFloor, targetFloor, clock.Now());
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::AddPassenger(int startFloor, int targetFloor, uint32_t arrivalTime) {
+    AddPassengers(startFloor, targetFloor, 1, arrivalTime);
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::AddPassengers(int startFloor, int targetFloor, int count, uint32_t arrivalTime) {
+    if (startFloor == targetFloor || count < 1) return;
+    if (startFloor < 0 || startFloor >= FloorCount() || targetFloor < 0 || targetFloor >= FloorCount()) return;
+
+    int firstId = nextPassengerId;
+    nextPassengerId += count;
+    // Bez wspólnej strefy pasażer jedzie najpierw na piętro przesiadki, a z pary pokładów idzie schodami.
+    int legFloor = targetFloor;
+    int transfer = routes.Empty() ? ZoneRoutes::DIRECT : routes.Transfer(startFloor, targetFloor);
+    if (transfer == ZoneRoutes::WALK || (config.stairsFloors > 0 && abs(targetFloor - startFloor) <= config.stairsFloors)) {
+        digest.Record(DigestEvent::ARRIVAL, arrivalTime, -1, startFloor, (uint32_t)targetFloor << 20 ^ (uint32_t)count);
+        deliveredPassengers += count;
+        walked += count;
+        return;
+    }
+    if (transfer >= 0) legFloor = transfer;
+    if (config.balkQueue > 0 && lobbies[startFloor].size >= config.balkQueue) {
+        digest.Record(DigestEvent::BALK, arrivalTime, -1, startFloor, (uint32_t)targetFloor << 20 ^ (uint32_t)count);
+        balked += count;
+        return;
+    }
+    int carIndex = AssignCar(startFloor, legFloor);
+    digest.Record(DigestEvent::ARRIVAL, arrivalTime, carIndex, startFloor, (uint32_t)targetFloor << 20 ^ (uint32_t)count);
+    if (Building::Parking(config) == ParkingPolicy::DEMAND) demand.Record(startFloor, count, arrivalTime);
+    LOG_EVENT(ASSIGN, arrivalTime, carIndex, startFloor, legFloor);
+
+    PassengerList& queue = CallCar(cars[carIndex], startFloor, legFloor, count);
+    for (int i = 0; i < count; ++i) {
+        Passenger p = { firstId + i, startFloor, legFloor };
+        p.car = carIndex;
+        p.arrivalTime = arrivalTime;
+        if (legFloor != targetFloor) p.finalFloor = targetFloor;
+        int slot = AllocateSlot();
+        passengers[slot] = p;
+        PushBack(queue, slot);
+        JoinLobby(lobbies[startFloor], slot);
+        if (config.patience > 0) StartPatience(slot, arrivalTime);
+    }
+}
+
+template <class Building>
+PassengerList& BasicElevatorBank<Building>::CallCar(Car& car, int startFloor, int targetFloor, int count) {
+    car.assignedPassengers += count;
+    car.hallCalls += count;
+    int stop = StopFloor(car, startFloor);
+    if (targetFloor < startFloor) {
+        car.upRequests.Add(stop, count);
+        car.waitingUp.Add(stop, count);
+        return car.queueUp[stop];
+    }
+    car.downRequests.Add(stop, count);
+    car.waitingDown.Add(stop, count);
+    return car.queueDown[stop];
+}
+
+// Pasażer wysiadł na piętrze przesiadki i czeka tam na kabinę strefy piętra docelowego.
+template <class Building>
+void BasicElevatorBank<Building>::Transfer(int slot) {
+    Passenger& p = passengers[slot];
+    p.startFloor = p.targetFloor;
+    p.targetFloor = p.finalFloor;
+    p.finalFloor = -1;
+    p.transferred = true;
+    transfers++;
+    uint32_t now = clock.Now();
+    p.car = AssignCar(p.startFloor, p.targetFloor);
+    digest.Record(DigestEvent::ARRIVAL, now, p.car, p.startFloor, (uint32_t)p.targetFloor << 20 ^ 1u);
+    if (Building::Parking(config) == ParkingPolicy::DEMAND) demand.Record(p.startFloor, 1, now);
+    LOG_EVENT(ASSIGN, now, p.car, p.startFloor, p.targetFloor);
+    PushBack(CallCar(cars[p.car], p.startFloor, p.targetFloor, 1), slot);
+    JoinLobby(lobbies[p.startFloor], slot);
+}
+
+// Przyjście z czasem wcześniejszym niż poprzednie (np. wezwanie z okna dodane z czasem z przeszłości)
+// dostaje dokładnie swój termin, bo kopiec nie wymaga kolejności dodawania.
+template <class Building>
+void BasicElevatorBank<Building>::StartPatience(int slot, uint32_t arrivalTime) {
+    patienceTimers.push_back({ arrivalTime + config.patience, slot, passengers[slot].id });
+    push_heap(patienceTimers.begin(), patienceTimers.end(), PatienceLater());
+}
+
+template <class Building>
+bool BasicElevatorBank<Building>::InLobby(int slot) const {
+    const Passenger& p = passengers[slot];
+    return p.lobbyPrev != -1 || p.lobbyNext != -1 || lobbies[p.startFloor].head == slot;
+}
+
+// Zdejmuje terminy, które minęły, i wpisy pasażerów, którzy już weszli do kabiny albo się przesiedli
+// (cierpliwość dotyczy tylko czekania na pierwszą kabinę).
+template <class Building>
+void BasicElevatorBank<Building>::ExpirePatience() {
+    uint32_t now = clock.Now();
+    while (!patienceTimers.empty()) {
+        PatienceTimer timer = patienceTimers.front();
+        const Passenger& p = passengers[timer.slot];
+        bool waiting = p.id == timer.id && !p.transferred && InLobby(timer.slot);
+        if (waiting && (int32_t)(now - timer.deadline) <= 0) break;
+        pop_heap(patienceTimers.begin(), patienceTimers.end(), PatienceLater());
+        patienceTimers.pop_back();
+        if (waiting) Renege(timer.slot);
+    }
+}
+
+template <class Building>
+bool BasicElevatorBank<Building>::NextPatienceDeadline(uint32_t& deadline) const {
+    if (patienceTimers.empty()) return false;
+    deadline = patienceTimers.front().deadline;
+    return true;
+}
+
+// Pasażer odchodzi z holu: wezwanie znika z kabiny tak, jakby nigdy jej nie przydzielono.
+template <class Building>
+void BasicElevatorBank<Building>::Renege(int slot) {
+    Passenger& p = passengers[slot];
+    Car& car = cars[p.car];
+    int stop = StopFloor(car, p.startFloor);
+    if (p.targetFloor < p.startFloor) {
+        car.waitingUp.Remove(stop);
+        car.upRequests.Remove(stop);
+        Unlink(car.queueUp[stop], slot);
+    }
+    else {
+        car.waitingDown.Remove(stop);
+        car.downRequests.Remove(stop);
+        Unlink(car.queueDown[stop], slot);
+    }
+    car.hallCalls--;
+    car.assignedPassengers--;
+    LeaveLobby(lobbies[p.startFloor], slot);
+    uint32_t now = clock.Now();
+    digest.Record(DigestEvent::RENEGE, now, car.index, p.startFloor, (uint32_t)p.id);
+    LOG_EVENT(RENEGE, now, car.index, p.startFloor, p.id);
+    reneged++;
+    FreeSlot(slot);
+}
+
+// Dyspozytorzy działają na ElevatorBank, a budynek o stałym kształcie ma jedną kabinę.
+template <class Building>
+int BasicElevatorBank<Building>::AssignCar(int, int) {
+    return 0;
+}
+
+template <>
+int BasicElevatorBank<RuntimeBuilding>::AssignCar(int startFloor, int targetFloor) {
+    return cars.size() > 1 ? dispatcher->AssignCar(*this, startFloor, targetFloor) : 0;
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::PushBack(PassengerList& list, int slot) {
+    Passenger& p = passengers[slot];
+    p.prev = list.tail;
+    p.next = -1;
+    if (list.tail != -1) passengers[list.tail].next = slot;
+    else list.head = slot;
+    list.tail = slot;
+    list.size++;
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::Unlink(PassengerList& list, int slot) {
+    Passenger& p = passengers[slot];
+    if (p.prev != -1) passengers[p.prev].next = p.next;
+    else list.head = p.next;
+    if (p.next != -1) passengers[p.next].prev = p.prev;
+    else list.tail = p.prev;
+    p.prev = p.next = -1;
+    list.size--;
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::TakePosition(vector<int>& positions, int slot) {
+    passengers[slot].posIndex = (int)positions.size();
+    positions.push_back(slot);
+}
+
+// Ostatni pasażer zajmuje zwolnione miejsce, więc pozostali nie zmieniają pozycji.
+template <class Building>
+void BasicElevatorBank<Building>::LeavePosition(vector<int>& positions, int slot) {
+    int index = passengers[slot].posIndex;
+    int last = positions.back();
+    positions[index] = last;
+    passengers[last].posIndex = index;
+    positions.pop_back();
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::JoinLobby(PassengerList& lobby, int slot) {
+    Passenger& p = passengers[slot];
+    p.posIndex = lobby.size;
+    p.lobbyPrev = lobby.tail;
+    p.lobbyNext = -1;
+    if (lobby.tail != -1) passengers[lobby.tail].lobbyNext = slot;
+    else lobby.head = slot;
+    lobby.tail = slot;
+    lobby.size++;
+}
+
+// Jak LeavePosition: ostatni w holu zajmuje miejsce wychodzącego, więc pozostali nie zmieniają pozycji.
+template <class Building>
+void BasicElevatorBank<Building>::LeaveLobby(PassengerList& lobby, int slot) {
+    int last = lobby.tail;
+    Passenger& l = passengers[last];
+    lobby.tail = l.lobbyPrev;
+    if (lobby.tail != -1) passengers[lobby.tail].lobbyNext = -1;
+    else lobby.head = -1;
+    if (last != slot) {
+        Passenger& p = passengers[slot];
+        l.lobbyPrev = p.lobbyPrev;
+        l.lobbyNext = p.lobbyNext;
+        if (l.lobbyPrev != -1) passengers[l.lobbyPrev].lobbyNext = last;
+        else lobby.head = last;
+        if (l.lobbyNext != -1) passengers[l.lobbyNext].lobbyPrev = last;
+        else lobby.tail = last;
+        l.posIndex = p.posIndex;
+    }
+    Passenger& p = passengers[slot];
+    p.lobbyPrev = p.lobbyNext = -1;
+    lobby.size--;
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::StartBoarding(Car& car, int slot) {
+    Passenger& p = passengers[slot];
+    p.animX = (float)(UI_WALL_START_X + 20 + p.posIndex * (PASSENGER_TOTAL_WIDTH + PASSENGER_SPACING));
+    p.animY = (float)(p.startFloor * FloorHeight() + (FloorHeight() - PASSENGER_TOTAL_HEIGHT));
+    p.boarding = true;
+    p.boardingProgress = 0.0f;
+    car.boardingPassengers++;
+    int stop = StopFloor(car, p.startFloor);
+    if (p.targetFloor < p.startFloor) {
+        car.waitingUp.Remove(stop);
+        Unlink(car.queueUp[stop], slot);
+    }
+    else {
+        car.waitingDown.Remove(stop);
+        Unlink(car.queueDown[stop], slot);
+    }
+    LeaveLobby(lobbies[p.startFloor], slot);
+    PushBack(car.boarding, slot);
+    TakePosition(car.occupants, slot);
+    if (config.boardingKernel != BoardingKernel::AOS) boardingBatch.Add(slot, p.animX, p.animY);
+    uint32_t now = clock.Now();
+    if (!p.transferred) {
+        p.boardTime = now;
+        metrics.wait.Record(now - p.arrivalTime);
+    }
+    digest.Record(DigestEvent::BOARD, now, car.index, p.startFloor, (uint32_t)p.id);
+    LOG_EVENT(BOARD, now, car.index, p.startFloor, p.id);
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::FinishBoarding(Car& car, int slot) {
+    Passenger& p = passengers[slot];
+    p.boardingProgress = 1.0f;
+    p.boarding = false;
+    p.inElevator = true;
+    car.boardingPassengers--;
+    car.hallCalls--;
+    if (p.targetFloor < p.startFloor) car.upRequests.Remove(StopFloor(car, p.startFloor));
+    else car.downRequests.Remove(StopFloor(car, p.startFloor));
+    int stop = StopFloor(car, p.targetFloor);
+    car.destinations.Add(stop);
+    car.passengersInside++;
+    Unlink(car.boarding, slot);
+    PushBack(car.riders[stop], slot);
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::Alight(Car& car, int slot) {
+    Passenger& p = passengers[slot];
+    int stop = StopFloor(car, p.targetFloor);
+    car.destinations.Remove(stop);
+    car.passengersInside--;
+    car.assignedPassengers--;
+    Unlink(car.riders[stop], slot);
+    LeavePosition(car.occupants, slot);
+    p.inElevator = false;
+    uint32_t now = clock.Now();
+    digest.Record(DigestEvent::ALIGHT, now, car.index, p.targetFloor, (uint32_t)p.id);
+    LOG_EVENT(ALIGHT, now, car.index, p.targetFloor, p.id);
+    if (p.finalFloor != -1) {
+        Transfer(slot);
+        return;
+    }
+    metrics.ride.Record(now - p.boardTime);
+    metrics.journey.Record(now - p.arrivalTime);
+    metrics.RecordDelivery(now);
+    FreeSlot(slot);
+    deliveredPassengers++;
+}
+
+// Kabina staje na piętrze. Nikt jeszcze nie wysiadł, więc liczba osób w kabinie to ładunek na ostatnim odcinku.
+template <class Building>
+void BasicElevatorBank<Building>::OpenDoors(Car& car) {
+    car.currentState = ElevatorState::STOPPED;
+    car.stateTimer = clock.Now();
+
+    CarStats& stats = metrics.cars[car.index];
+    int floor = FloorFromY(car.elevatorY);
+    digest.Record(DigestEvent::STOP, car.stateTimer, car.index, floor, (uint32_t)(car.passengersInside + car.boardingPassengers));
+    stats.stops++;
+    if (floor != stats.lastStopFloor) {
+        int floors = abs(floor - stats.lastStopFloor);
+        int direction = floor < stats.lastStopFloor ? 1 : -1;
+        stats.floorsTravelled += floors;
+        stats.passengerFloors += (uint64_t)floors * (car.passengersInside + car.boardingPassengers);
+        if (direction != stats.lastTravelDirection) {
+            if (stats.lastTravelDirection != 0) stats.reversals++;
+            stats.trips++;
+            stats.lastTravelDirection = direction;
+        }
+        stats.lastStopFloor = floor;
+    }
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::DecideNextMove(Car& car) {
+    int currentFloor = FloorFromY(car.elevatorY);
+    LOG_EVENT(DECIDE, clock.Now(), car.index, currentFloor, car.passengersInside);
+
+    if (car.passengersInside == 0 && car.hallCalls == 0) {
+        if (car.currentState != ElevatorState::IDLE) {
+            car.stateTimer = clock.Now();
+        }
+        car.currentState = ElevatorState::IDLE;
+        car.currentDirection = Direction::NONE;
+        car.targetFloor = -1;
+        return;
+    }
+
+    bool is_full = (car.passengersInside >= Building::FullThreshold(config) * car.decks);
+    if (is_full && car.hallCalls > 0) LOG_EVENT(FULL, clock.Now(), car.index, currentFloor, car.passengersInside);
+    if (car.currentDirection == Direction::NONE) {
+        int closest_task = -1;
+        int min_dist = FloorCount();
+        auto consider = [&](const typename Building::FloorMask& floors) {
+            int floor = floors.Nearest(currentFloor);
+            if (floor != -1 && abs(floor - currentFloor) < min_dist) {
+                min_dist = abs(floor - currentFloor);
+                closest_task = floor;
+            }
+        };
+        consider(car.destinations.floors);
+        if (!is_full) {
+            consider(car.upRequests.floors);
+            consider(car.downRequests.floors);
+        }
+        if (closest_task != -1) car.targetFloor = closest_task;
+        else { car.currentState = ElevatorState::IDLE; return; }
+
+        if (car.targetFloor == currentFloor) {
+            OpenDoors(car);
+        }
+        else {
+            car.currentState = ElevatorState::MOVING;
+            car.currentDirection = (car.targetFloor < currentFloor) ? Direction::UP : Direction::DOWN;
+            StartTrip(car);
+        }
+        return;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        int next_stop = -1;
+        if (car.currentDirection == Direction::UP) {
+            next_stop = car.destinations.floors.LastUpTo(currentFloor);
+            if (!is_full) next_stop = max(next_stop, car.upRequests.floors.LastUpTo(currentFloor));
+        }
+        else {
+            next_stop = car.destinations.floors.FirstFrom(currentFloor);
+            if (!is_full) {
+                int request = car.downRequests.floors.FirstFrom(currentFloor);
+                if (request != -1 && (next_stop == -1 || request < next_stop)) next_stop = request;
+            }
+        }
+
+        if (next_stop != -1) {
+            car.targetFloor = next_stop;
+            if (car.targetFloor == currentFloor) {
+                OpenDoors(car);
+            }
+            else {
+                car.currentState = ElevatorState::MOVING;
+                StartTrip(car);
+            }
+            return;
+        }
+        car.currentDirection = (car.currentDirection == Direction::UP) ? Direction::DOWN : Direction::UP;
+    }
+
+    car.currentState = ElevatorState::IDLE;
+    car.currentDirection = Direction::NONE;
+}
+
+// Przejazd zaczyna się z postoju w bieżącej chwili. W modelu CONSTANT kabina jedzie krokami w MoveElevator.
+template <class Building>
+void BasicElevatorBank<Building>::StartTrip(Car& car) {
+    if (Building::Motion(config) != MotionModel::JERK) return;
+    car.tripStart = clock.Now();
+    car.tripStartY = car.elevatorY;
+    PlanTrip(car);
+}
+
+// Profil od startu przejazdu do targetFloor. Po zmianie celu start się nie zmienia: CanStopAt gwarantuje,
+// że nowy profil pokrywa się ze starym do bieżącej chwili.
+template <class Building>
+void BasicElevatorBank<Building>::PlanTrip(Car& car) {
+    double distance = abs((double)car.targetFloor * FloorHeight() - car.tripStartY) / PixelsPerMeter();
+    car.trip = MotionProfile(MotionLimitsFor(config), distance);
+    car.tripDuration = (uint32_t)ceil(car.trip.Duration() * 1000.0);
+}
+
+// Czy kabina może zmienić cel na floor i dojechać tam bez przekraczania ograniczeń, czyli czy do tej chwili
+// jechała tak samo, jak jechałaby od startu prosto na floor.
+template <class Building>
+bool BasicElevatorBank<Building>::CanStopAt(const Car& car, int floor) const {
+    double distance = abs((double)floor * FloorHeight() - car.tripStartY) / PixelsPerMeter();
+    MotionProfile stop(MotionLimitsFor(config), distance);
+    return (clock.Now() - car.tripStart) / 1000.0 <= car.trip.SharedUntil(stop);
+}
+
+template <class Building>
+float BasicElevatorBank<Building>::TripY(const Car& car, uint32_t time) const {
+    double moved = car.trip.Position((time - car.tripStart) / 1000.0) * PixelsPerMeter();
+    bool up = (float)car.targetFloor * FloorHeight() < car.tripStartY;
+    return (float)(up ? car.tripStartY - moved : car.tripStartY + moved);
+}
+
+// Odpowiednik ruchu w MoveElevator dla modelu JERK: położenie z profilu, postój po czasie przejazdu
+// i zatrzymanie po drodze na parter tylko tam, gdzie kabina jeszcze zdąży wyhamować.
+template <class Building>
+void BasicElevatorBank<Building>::MoveAlongTrip(Car& car) {
+    uint32_t now = clock.Now();
+    if (now - car.tripStart >= car.tripDuration) {
+        car.elevatorY = (float)car.targetFloor * FloorHeight();
+        OpenDoors(car);
+        return;
+    }
+    car.elevatorY = TripY(car, now);
+    if (car.currentDirection == Direction::DOWN && car.targetFloor == car.homeFloor
+        && car.passengersInside < Building::FullThreshold(config) * car.decks) {
+        const auto& waiting = car.waitingDown.floors;
+        for (int floor = waiting.FirstFrom(FloorFromY(car.elevatorY)); floor != -1 && floor < car.targetFloor; floor = waiting.FirstFrom(floor + 1)) {
+            if (CanStopAt(car, floor)) {
+                car.targetFloor = floor;
+                PlanTrip(car);
+                return;
+            }
+        }
+    }
+}
+
+template <class Building>
+float BasicElevatorBank<Building>::BoardingTargetX(const Car& car, const Passenger& p) const {
+    int elevatorX = GetElevatorScreenX(car.index);
+    return elevatorX + (ELEVATOR_WIDTH - (Building::FullThreshold(config) * (PASSENGER_TOTAL_WIDTH + PASSENGER_SPACING))) / 2.0f + (p.posIndex * (PASSENGER_TOTAL_WIDTH + PASSENGER_SPACING));
+}
+
+template <class Building>
+float BasicElevatorBank<Building>::BoardingTargetY(const Car& car) const {
+    int elevatorScreenY = (int)car.elevatorY + FloorHeight() - ELEVATOR_HEIGHT;
+    return (float)(elevatorScreenY + ELEVATOR_HEIGHT - PASSENGER_TOTAL_HEIGHT);
+}
+
+// Cele są zbierane do tablic, krok liczy StepBoarding dla wszystkich kabin naraz, a pasażerowie
+// w celu kończą wsiadanie w kolejności rozpoczęcia, tak jak w pętli po listach kabin.
+template <class Building>
+void BasicElevatorBank<Building>::StepBoardingBatch() {
+    BoardingBatch& batch = boardingBatch;
+    size_t count = batch.Size();
+    if (count == 0) return;
+    for (size_t i = 0; i < count; ++i) {
+        const Passenger& p = passengers[batch.slot[i]];
+        batch.targetX[i] = BoardingTargetX(cars[p.car], p);
+        batch.targetY[i] = BoardingTargetY(cars[p.car]);
+    }
+    StepBoarding(config.boardingKernel, batch.x.data(), batch.y.data(), batch.targetX.data(), batch.targetY.data(),
+        batch.arrived.data(), count, config.walkSpeed);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int slot = batch.slot[i];
+        Passenger& p = passengers[slot];
+        p.animX = batch.x[i];
+        p.animY = batch.y[i];
+        if (batch.arrived[i]) {
+            FinishBoarding(cars[p.car], slot);
+            continue;
+        }
+        batch.slot[kept] = slot;
+        batch.x[kept] = batch.x[i];
+        batch.y[kept] = batch.y[i];
+        kept++;
+    }
+    batch.Resize(kept);
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::MoveElevator() {
+    if (!patienceTimers.empty()) ExpirePatience();
+    if (config.boardingKernel != BoardingKernel::AOS) {
+        StepBoardingBatch();
+        for (auto& car : cars) MoveElevator(car);
+        return;
+    }
+
+    for (auto& car : cars) {
+        for (int slot = car.boarding.head; slot != -1;) {
+            Passenger& p = passengers[slot];
+            int next = p.next;
+            float targetX = BoardingTargetX(car, p);
+            float targetY = BoardingTargetY(car);
+
+            float dx = targetX - p.animX;
+            float dy = targetY - p.animY;
+            float dist = sqrt(dx * dx + dy * dy);
+            if (dist < config.walkSpeed) {
+                p.animX = targetX;
+                p.animY = targetY;
+                FinishBoarding(car, slot);
+            }
+            else {
+                p.animX += config.walkSpeed * dx / dist;
+                p.animY += config.walkSpeed * dy / dist;
+            }
+            slot = next;
+        }
+    }
+    for (auto& car : cars) MoveElevator(car);
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::MoveElevator(Car& car) {
+    ElevatorState state = car.currentState;
+    Direction direction = car.currentDirection;
+    int targetFloor = car.targetFloor;
+    switch (car.currentState) {
+    case ElevatorState::IDLE: {
+        if (car.hallCalls > 0) {
+            DecideNextMove(car);
+        }
+        else if (clock.Now() - car.stateTimer > Building::IdleReturnDelay(config)) {
+            int currentFloor = FloorFromY(car.elevatorY);
+            int parkingFloor = ParkingFloor(car);
+            if (parkingFloor != currentFloor) {
+                car.targetFloor = parkingFloor;
+                car.currentState = ElevatorState::MOVING;
+                car.currentDirection = parkingFloor > currentFloor ? Direction::DOWN : Direction::UP;
+                StartTrip(car);
+            }
+        }
+        break;
+    }
+
+    case ElevatorState::MOVING: {
+        if (car.targetFloor == -1) {
+            car.currentState = ElevatorState::IDLE;
+            break;
+        }
+        if (Building::Motion(config) == MotionModel::JERK) {
+            MoveAlongTrip(car);
+            break;
+        }
+        float targetY = (float)car.targetFloor * FloorHeight();
+        if (abs(car.elevatorY - targetY) < Building::Speed(config)) {
+            car.elevatorY = targetY;
+            OpenDoors(car);
+        }
+        else {
+            if (car.elevatorY > targetY) car.elevatorY -= Building::Speed(config);
+            else car.elevatorY += Building::Speed(config);
+            if (car.currentDirection == Direction::DOWN && car.targetFloor == car.homeFloor
+                && car.passengersInside < Building::FullThreshold(config) * car.decks) {
+                int currentFloor = FloorFromY(car.elevatorY);
+                int floor = car.waitingDown.floors.FirstFrom(currentFloor);
+                if (floor != -1 && floor < car.targetFloor) {
+                    car.targetFloor = floor;
+                    car.currentState = ElevatorState::MOVING;
+                    break;
+                }
+            }
+        }
+        break;
+    }
+
+
+    case ElevatorState::STOPPED: {
+        if (clock.Now() - car.stateTimer > Building::DoorOpenDuration(config)) {
+            // W kabinie dwupokładowej na tym postoju wysiadają i wsiadają pasażerowie obu pięter pary.
+            int currentFloor = FloorFromY(car.elevatorY);
+            PassengerList& arrived = car.riders[currentFloor];
+            while (arrived.head != -1) Alight(car, arrived.head);
+
+            float weight = 0;
+            for (int i = 0; i < car.passengersInside + car.boardingPassengers; ++i) weight += Building::WeightPerPerson(config);
+
+            Direction boardingDirection = car.currentDirection;
+            if (boardingDirection == Direction::NONE) {
+                bool wants_up = car.waitingUp.count[currentFloor] > 0;
+                bool wants_down = car.waitingDown.count[currentFloor] > 0;
+                if (wants_up) boardingDirection = Direction::UP;
+                else if (wants_down) boardingDirection = Direction::DOWN;
+            }
+
+            bool boardsUp = boardingDirection == Direction::UP && car.waitingUp.count[currentFloor] > 0;
+            bool boardsDown = boardingDirection == Direction::DOWN && car.waitingDown.count[currentFloor] > 0;
+            if (boardsUp || boardsDown) {
+                PassengerList& queue = boardsUp ? car.queueUp[currentFloor] : car.queueDown[currentFloor];
+                while (queue.head != -1 && weight + Building::WeightPerPerson(config) <= Building::MaxWeight(config) * car.decks) {
+                    StartBoarding(car, queue.head);
+                    weight += Building::WeightPerPerson(config);
+                }
+            }
+
+            if (car.currentDirection == Direction::NONE && boardingDirection != Direction::NONE) {
+                car.currentDirection = boardingDirection;
+            }
+
+            DecideNextMove(car);
+        }
+        break;
+    }
+
+    }
+    if (car.currentDirection != direction) {
+        digest.Record(DigestEvent::DIRECTION, clock.Now(), car.index, FloorFromY(car.elevatorY), (uint32_t)car.currentDirection);
+        LOG_EVENT(DIRECTION, clock.Now(), car.index, FloorFromY(car.elevatorY), (int)car.currentDirection);
+    }
+    if (car.currentState != state) LOG_EVENT(STATE, clock.Now(), car.index, FloorFromY(car.elevatorY), (int)car.currentState);
+    if (car.targetFloor != targetFloor) LOG_EVENT(TARGET, clock.Now(), car.index, targetFloor, car.targetFloor);
+}
+
+template <class Building>
+int BasicElevatorBank<Building>::ParkedFloor(const Car& car) const {
+    if (car.hallCalls > 0 || car.passengersInside > 0 || car.boardingPassengers > 0) return -1;
+    if (car.currentState == ElevatorState::IDLE) return FloorFromY(car.elevatorY);
+    if (car.currentState == ElevatorState::MOVING) return car.targetFloor;
+    return -1;
+}
+
+// Wolne kabiny jednej strefy dzielą między siebie rozkład wezwań w kolejności pięter, na których stoją
+// (lub na które jadą), więc każda dostaje inny kwantyl, a ich cele się nie krzyżują. Kabina strefy staje
+// na najbliższym obsługiwanym piętrze.
+template <class Building>
+int BasicElevatorBank<Building>::ParkingFloor(const Car& car) const {
+    if (Building::Parking(config) == ParkingPolicy::GROUND) return car.homeFloor;
+    int floor = FloorFromY(car.elevatorY);
+    int rank = 0;
+    int parked = 1;
+    for (const auto& other : cars) {
+        if (other.index == car.index || other.zone != car.zone) continue;
+        int otherFloor = ParkedFloor(other);
+        if (otherFloor == -1) continue;
+        parked++;
+        if (otherFloor < floor || (otherFloor == floor && other.index < car.index)) rank++;
+    }
+    int parking = demand.ParkingFloor(clock.Now(), rank, parked, car.homeFloor);
+    return car.zone == -1 ? parking : StopFloor(car, car.served.Nearest(parking));
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::FastForward(uint32_t ticks) {
+    for (auto& car : cars) FastForward(car, ticks);
+}
+
+template <class Building>
+void BasicElevatorBank<Building>::FastForward(Car& car, uint32_t ticks) {
+    if (car.currentState != ElevatorState::MOVING || car.targetFloor == -1) return;
+    if (Building::Motion(config) == MotionModel::JERK) {
+        car.elevatorY = TripY(car, clock.Now() + ticks * TICK_DURATION);
+        return;
+    }
+    float targetY = (float)car.targetFloor * FloorHeight();
+    for (uint32_t i = 0; i < ticks; ++i) {
+        if (car.elevatorY > targetY) car.elevatorY -= Building::Speed(config);
+        else car.elevatorY += Building::Speed(config);
+    }
+}
+
+template <class Building>
+bool BasicElevatorBank<Building>::HasBoardingPassengers() const {
+    for (const auto& car : cars) if (car.boardingPassengers > 0) return true;
+    return false;
+}
+
+template struct BasicElevatorBank<RuntimeBuilding>;
+template struct BasicElevatorBank<FourFloorBuilding>;
@@ -0,0 +1,281 @@
+﻿#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "BuildingConfig.h"
+#include "BuildingPolicy.h"
+#include "Digest.h"
+#include "FloorSet.h"
+#include "Metrics.h"
+
+const int ELEVATOR_WIDTH = 140;
+const int ELEVATOR_HEIGHT = 100;
+const int ELEVATOR_SPACING = 10;
+const uint32_t TICK_DURATION = 33;
+// Domyślna prędkość dojścia do kabiny (BuildingConfig::walkSpeed).
+const float BOARDING_SPEED = 4.0f;
+
+const int PASSENGER_HEAD_RADIUS = 6;
+const int PASSENGER_BODY_HEIGHT = 15;
+const int PASSENGER_ARM_SPAN = 15;
+const int PASSENGER_LEG_LENGTH = 15;
+const int PASSENGER_TOTAL_HEIGHT = PASSENGER_HEAD_RADIUS * 2 + PASSENGER_BODY_HEIGHT + PASSENGER_LEG_LENGTH;
+const int PASSENGER_TOTAL_WIDTH = PASSENGER_HEAD_RADIUS * 2;
+const int PASSENGER_SPACING = 5;
+const int UI_WALL_START_X = 100;
+// Najmniejsza szerokość ściany; przy wielu kabinach ściana sięga za ostatnią kabinę.
+const int UI_WALL_WIDTH = 500;
+// Kabina 0 stoi w tym miejscu, kolejne na prawo od niej, za holem z czekającymi.
+const int ELEVATOR_SHAFT_X = UI_WALL_START_X + UI_WALL_WIDTH - 150;
+const int ELEVATOR_WALL_MARGIN = 10;
+
+enum class ElevatorState {
+    IDLE,
+    MOVING,
+    STOPPED
+};
+enum class Direction {
+    UP,
+    DOWN,
+    NONE
+};
+struct Passenger {
+    int id;
+    int startFloor;
+    int targetFloor;
+    int car = 0;
+    uint32_t arrivalTime = 0;
+    uint32_t boardTime = 0;
+    // Piętro docelowe po przesiadce na targetFloor albo -1; transferred po przesiadce (czekanie i jazda
+    // liczą się od pierwszego wejścia).
+    int finalFloor = -1;
+    bool transferred = false;
+    bool inElevator = false;
+    bool boarding = false;
+    float animX = 0.0f;
+    float animY = 0.0f;
+    float boardingProgress = 0.0f;
+    int posIndex = 0;
+    int prev = -1;
+    int next = -1;
+    // Miejsce w holu na piętrze startowym, niezależne od kolejki kabiny (prev/next).
+    int lobbyPrev = -1;
+    int lobbyNext = -1;
+};
+
+// Lista pasażerów spięta polami prev/next; elementy to indeksy w ElevatorBank::passengers.
+// Pasażer jest zawsze na co najwyżej jednej liście: w kolejce na piętrze, przy wsiadaniu albo w kabinie.
+// Wolne miejsca w ElevatorBank::passengers też są spięte polem next.
+struct PassengerList {
+    int head = -1;
+    int tail = -1;
+    int size = 0;
+};
+
+// Źródło czasu w milisekundach. W oknie jest to GetTickCount(), w trybie wsadowym zegar symulowany.
+class Clock {
+public:
+    virtual ~Clock() = default;
+    virtual uint32_t Now() const = 0;
+};
+
+class ManualClock : public Clock {
+public:
+    uint32_t Now() const override { return time; }
+    void Advance(uint32_t ms) { time += ms; }
+    void Set(uint32_t ms) { time = ms; }
+private:
+    uint32_t time = 0;
+};
+
+int GetElevatorScreenX(int carIndex);
+// Prawy koniec ściany budynku z carCount kabinami.
+int GetWallEndX(int carCount);
+
+template <class Building>
+struct BasicElevator {
+    typedef BasicFloorRequests<typename Building::FloorMask> Requests;
+
+    int index = 0;
+    ElevatorState currentState = ElevatorState::IDLE;
+    Direction currentDirection = Direction::NONE;
+    float elevatorY = 0.0f;
+    int targetFloor = -1;
+    uint32_t stateTimer = 0;
+    int assignedPassengers = 0;
+    int passengersInside = 0;
+
+    // Strefa kabiny (indeks w config.zones albo -1), piętra, na których staje, liczba pokładów i piętro postoju
+    // (parter albo najniższe piętro strefy). Kabina dwupokładowa trzyma zgłoszenia, kolejki i jadących
+    // według piętra postoju pokładu dolnego (DeckStopFloor), a pojemność ma podwójną.
+    int zone = -1;
+    int decks = 1;
+    int homeFloor = 0;
+    typename Building::FloorMask served;
+
+    // Bieżący przejazd w modelu ruchu JERK: chwila i położenie startu oraz profil do targetFloor.
+    // Położenie kabiny wynika z czasu od startu, więc nie zależy od długości kroku.
+    uint32_t tripStart = 0;
+    float tripStartY = 0.0f;
+    uint32_t tripDuration = 0;
+    MotionProfile trip;
+
+    // Zgłoszenia aktualizowane przy dodaniu, wejściu i wyjściu pasażera, żeby DecideNextMove
+    // nie musiało przeglądać wszystkich pasażerów.
+    Requests destinations;
+    Requests upRequests;
+    Requests downRequests;
+    Requests waitingUp;
+    Requests waitingDown;
+    int hallCalls = 0;
+    int boardingPassengers = 0;
+
+    // Kolejki oczekujących na każdym piętrze (osobno w górę i w dół), wsiadający
+    // oraz jadący pogrupowani według piętra docelowego.
+    std::vector<PassengerList> queueUp;
+    std::vector<PassengerList> queueDown;
+    std::vector<PassengerList> riders;
+    PassengerList boarding;
+    // Miejsca w kabinie; posIndex pasażera to indeks w tej tablicy.
+    std::vector<int> occupants;
+};
+
+typedef BasicElevator<RuntimeBuilding> Elevator;
+
+class Dispatcher;
+
+// Zespół wind. Każde wezwanie z piętra jest przydzielane przez dyspozytora do jednej kabiny
+// i tylko ta kabina je obsługuje. Building (BuildingPolicy.h) decyduje, czy kształt budynku jest znany
+// przy kompilacji; dyspozytor jest używany tylko w RuntimeBuilding. Szablon jest konkretyzowany
+// w Simulation.cpp dla RuntimeBuilding i FourFloorBuilding.
+template <class Building>
+struct BasicElevatorBank {
+    typedef BasicElevator<Building> Car;
+
+    BasicElevatorBank(const Clock& clock, const BuildingConfig& config = Building::DefaultConfig(), std::unique_ptr<Dispatcher> dispatcher = nullptr);
+    ~BasicElevatorBank();
+
+    const Clock& clock;
+    const BuildingConfig config;
+
+    std::vector<Car> cars;
+    std::unique_ptr<Dispatcher> dispatcher;
+
+    // Pula pasażerów. Miejsca po wysiadających są używane ponownie (lista wolnych miejsc),
+    // więc indeksy na listach pozostają ważne, a po Reserve krok symulacji nie przydziela pamięci.
+    std::vector<Passenger> passengers;
+    // Oczekujący na każdym piętrze, spięci polami lobbyPrev/lobbyNext w kolejności posIndex.
+    std::vector<PassengerList> lobbies;
+    int nextPassengerId = 0;
+    int deliveredPassengers = 0;
+    // Czasy czekania, jazdy i podróży oraz liczniki kabin (metrics.cars[car.index]).
+    SimulationMetrics metrics;
+    // Skrót zdarzeń od początku przebiegu, do porównywania przebiegów (Digest.h).
+    StateDigest digest;
+    // Wezwania z pięter, uczone tylko w polityce postoju DEMAND.
+    DemandModel demand;
+    // Przesiadki między strefami; puste bez stref. transfers to liczba przesiadek od początku przebiegu.
+    ZoneRoutes routes;
+    uint64_t transfers = 0;
+    // Pasażerowie, którzy odeszli z kolejki po config.patience, zrezygnowali z windy przy przyjściu
+    // (config.balkQueue) i poszli schodami (config.stairsFloors albo para pokładów).
+    uint64_t reneged = 0;
+    uint64_t balked = 0;
+    uint64_t walked = 0;
+
+    void AddPassenger(int startFloor, int targetFloor);
+    void AddPassenger(int startFloor, int targetFloor, uint32_t arrivalTime);
+    // Grupa count osób z jednego wezwania: dyspozytor wybiera kabinę raz, liczniki zgłoszeń są zwiększane
+    // raz o count, a pasażerowie trafiają na koniec kolejki kabiny i holu w kolejności numerów.
+    void AddPassengers(int startFloor, int targetFloor, int count, uint32_t arrivalTime);
+    size_t PassengersInSystem() const { return passengers.size() - freeCount; }
+    // Rezerwuje pulę na passengerCount pasażerów naraz.
+    void Reserve(size_t passengerCount);
+    void DecideNextMove(Car& car);
+    void MoveElevator();
+    void MoveElevator(Car& car);
+
+    // Wykonuje kroki, w których nic poza ruchem kabin się nie zmienia (bez przeglądania pasażerów).
+    void FastForward(uint32_t ticks);
+    void FastForward(Car& car, uint32_t ticks);
+    bool HasBoardingPassengers() const;
+    bool HasWaitingPassengers(const Car& car) const { return car.hallCalls > 0; }
+    // Piętro, na które wolna kabina jedzie po idleReturnDelay (Building::Parking).
+    int ParkingFloor(const Car& car) const;
+    // Czy kabina może przewieźć pasażera wprost: staje na obu piętrach, a dwupokładowa na różnych postojach.
+    bool Serves(const Car& car, int startFloor, int targetFloor) const {
+        return car.served.Test(startFloor) && car.served.Test(targetFloor) && StopFloor(car, startFloor) != StopFloor(car, targetFloor);
+    }
+    // Piętro, na którym kabina staje, żeby obsłużyć floor.
+    int StopFloor(const Car& car, int floor) const { return car.decks == 1 ? floor : DeckStopFloor(floor, GroundFloor()); }
+    // Najbliższy termin cierpliwości czekającego; false, gdy nikt nie czeka z terminem.
+    bool NextPatienceDeadline(uint32_t& deadline) const;
+
+private:
+    friend struct SnapshotAccess;
+
+    int FloorCount() const { return Building::FloorCount(config); }
+    int GroundFloor() const { return Building::FloorCount(config) - 1; }
+    int FloorHeight() const { return Building::FloorHeight(config); }
+    int FloorFromY(float y) const { return (int)std::round(y / Building::FloorHeight(config)); }
+    int CarCapacity() const { return (int)(Building::MaxWeight(config) / Building::WeightPerPerson(config)); }
+    int AssignCar(int startFloor, int targetFloor);
+    // Dopisuje count wezwań z startFloor do kabiny i zwraca kolejkę, do której trafiają pasażerowie.
+    PassengerList& CallCar(Car& car, int startFloor, int targetFloor, int count);
+    void Transfer(int slot);
+    // Pasażer czeka w holu od arrivalTime; po config.patience ms bez wejścia do kabiny odchodzi (Renege).
+    void StartPatience(int slot, uint32_t arrivalTime);
+    void ExpirePatience();
+    void Renege(int slot);
+    bool InLobby(int slot) const;
+    // Piętro wolnej kabiny albo cel jej jazdy na postój; -1 dla kabiny z pasażerami lub wezwaniami.
+    int ParkedFloor(const Car& car) const;
+
+    double PixelsPerMeter() const { return FloorHeight() / (double)config.floorHeightMeters; }
+    void StartTrip(Car& car);
+    void PlanTrip(Car& car);
+    bool CanStopAt(const Car& car, int floor) const;
+    float TripY(const Car& car, uint32_t time) const;
+    void MoveAlongTrip(Car& car);
+
+    void StartBoarding(Car& car, int slot);
+    void FinishBoarding(Car& car, int slot);
+    void Alight(Car& car, int slot);
+    void OpenDoors(Car& car);
+    float BoardingTargetX(const Car& car, const Passenger& p) const;
+    float BoardingTargetY(const Car& car) const;
+    void StepBoardingBatch();
+
+    void PushBack(PassengerList& list, int slot);
+    void Unlink(PassengerList& list, int slot);
+    void TakePosition(std::vector<int>& positions, int slot);
+    void LeavePosition(std::vector<int>& positions, int slot);
+    void JoinLobby(PassengerList& lobby, int slot);
+    void LeaveLobby(PassengerList& lobby, int slot);
+    int AllocateSlot();
+    void FreeSlot(int slot);
+
+    int freeHead = -1;
+    size_t freeCount = 0;
+    // Terminy cierpliwości w kopcu z najbliższym na wierzchu (przy równych terminach wcześniejszy pasażer):
+    // co krok sprawdzany jest tylko wierzch, a dodanie i zdjęcie terminu kosztuje O(log n), także gdy
+    // przyjście ma czas wcześniejszy niż poprzednie. Wpisy pasażerów, którzy już weszli, są pomijane przy zdjęciu.
+    struct PatienceTimer {
+        uint32_t deadline;
+        int slot;
+        int id;
+    };
+    struct PatienceLater {
+        bool operator()(const PatienceTimer& a, const PatienceTimer& b) const {
+            int32_t diff = (int32_t)(a.deadline - b.deadline);
+            return diff != 0 ? diff > 0 : a.id > b.id;
+        }
+    };
+    std::vector<PatienceTimer> patienceTimers;
+    BoardingBatch boardingBatch;
+};
+
+typedef BasicElevatorBank<RuntimeBuilding> ElevatorBank;
@@ -0,0 +1,298 @@
+﻿#include <memory>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Dispatcher.h"
+#include "EventLog.h"
+#include "EventScheduler.h"
+#include "Simulation.h"
+#include "Trace.h"
+
+using namespace std;
+
+namespace {
+
+const vector<int64_t> PASSENGER_COUNTS = { 10, 1000, 100000, 1000000 };
+// Droga do kabiny rośnie z kolejką w holu, więc wsiadanie miliona osób naraz trwałoby minuty.
+const vector<int64_t> BOARDING_COUNTS = { 10, 1000, 100000 };
+const vector<int64_t> FLOOR_COUNTS = { 20, 200 };
+const int CAR_COUNT = 4;
+
+struct Building {
+    ManualClock clock;
+    ElevatorBank bank;
+
+    explicit Building(const BuildingConfig& config, const char* dispatcher = "nearest")
+        : bank(clock, config, CreateDispatcher(dispatcher)) {}
+};
+
+BuildingConfig MakeConfig(int floors, int cars) {
+    BuildingConfig config;
+    config.floorCount = floors;
+    config.carCount = cars;
+    return config;
+}
+
+vector<pair<int, int>> RandomTrips(int floors, size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> floorDist(0, floors - 1);
+    vector<pair<int, int>> trips(count);
+    for (auto& trip : trips) {
+        trip.first = floorDist(rng);
+        do trip.second = floorDist(rng); while (trip.second == trip.first);
+    }
+    return trips;
+}
+
+void AddTrips(ElevatorBank& bank, const vector<pair<int, int>>& trips) {
+    bank.Reserve(bank.passengers.size() + trips.size());
+    for (const auto& trip : trips) bank.AddPassenger(trip.first, trip.second);
+}
+
+// Przydział wezwania, kolejki kabiny i hol: dodanie passengers osób do pustego budynku.
+void BM_AddPassenger(BenchmarkState& state) {
+    size_t count = (size_t)state.Range(0);
+    int floors = (int)state.Range(1);
+    vector<pair<int, int>> trips = RandomTrips(floors, count, 1);
+    unique_ptr<Building> building;
+    for ([[maybe_unused]] auto _ : state) {
+        state.PauseTiming();
+        building.reset();
+        building = make_unique<Building>(MakeConfig(floors, CAR_COUNT));
+        building->bank.Reserve(count);
+        state.ResumeTiming();
+        for (const auto& trip : trips) building->bank.AddPassenger(trip.first, trip.second);
+    }
+    state.SetItemsProcessed(state.Iterations() * count);
+}
+
+// Ta sama liczba osób w grupach po group z jednego wezwania (AddPassengers): jeden przydział na grupę.
+void BM_AddPassengerGroups(BenchmarkState& state) {
+    size_t count = (size_t)state.Range(0);
+    int group = (int)state.Range(1);
+    vector<pair<int, int>> calls = RandomTrips(20, count / group, 5);
+    unique_ptr<Building> building;
+    for ([[maybe_unused]] auto _ : state) {
+        state.PauseTiming();
+        building.reset();
+        building = make_unique<Building>(MakeConfig(20, CAR_COUNT), "eta");
+        building->bank.Reserve(count);
+        state.ResumeTiming();
+        for (const auto& call : calls) building->bank.AddPassengers(call.first, call.second, group, 0);
+    }
+    state.SetItemsProcessed(state.Iterations() * calls.size() * group);
+}
+
+// Wybór następnego postoju przy passengers czekających: raz bez kierunku (najbliższe zadanie)
+// i raz z kierunkiem ustalonym przez pierwsze wywołanie.
+void BM_DecideNextMove(BenchmarkState& state) {
+    int floors = (int)state.Range(1);
+    Building building(MakeConfig(floors, CAR_COUNT));
+    ElevatorBank& bank = building.bank;
+    AddTrips(bank, RandomTrips(floors, (size_t)state.Range(0), 2));
+    for ([[maybe_unused]] auto _ : state) {
+        for (auto& car : bank.cars) {
+            car.currentState = ElevatorState::IDLE;
+            car.currentDirection = Direction::NONE;
+            bank.DecideNextMove(car);
+            bank.DecideNextMove(car);
+        }
+    }
+    state.SetItemsProcessed(state.Iterations() * bank.cars.size() * 2);
+}
+
+// Krok symulacji przy stałej liczbie osób w systemie: dowiezieni są od razu zastępowani nowymi.
+void BM_MoveElevator(BenchmarkState& state) {
+    size_t count = (size_t)state.Range(0);
+    int floors = (int)state.Range(1);
+    Building building(MakeConfig(floors, CAR_COUNT));
+    ElevatorBank& bank = building.bank;
+    AddTrips(bank, RandomTrips(floors, count, 3));
+    vector<pair<int, int>> refill = RandomTrips(floors, 4096, 4);
+    size_t next = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        building.clock.Advance(TICK_DURATION);
+        bank.MoveElevator();
+        while (bank.PassengersInSystem() < count) {
+            const auto& trip = refill[next++ & 4095];
+            bank.AddPassenger(trip.first, trip.second);
+        }
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+// Budynek z okna (4 piętra, jedna kabina) z kształtem znanym przy kompilacji (FourFloorBuilding)
+// albo z BuildingConfig (RuntimeBuilding), ta sama konfiguracja i ci sami pasażerowie.
+template <class Shape>
+struct SmallBuilding {
+    ManualClock clock;
+    BasicElevatorBank<Shape> bank;
+
+    explicit SmallBuilding(size_t passengers) : bank(clock, FourFloorBuilding::DefaultConfig()) {
+        bank.Reserve(passengers);
+        for (const auto& trip : RandomTrips(FourFloorShape::FLOOR_COUNT, passengers, 6)) bank.AddPassenger(trip.first, trip.second);
+    }
+};
+
+template <class Shape>
+void BM_FourFloorDecide(BenchmarkState& state) {
+    SmallBuilding<Shape> building((size_t)state.Range(0));
+    auto& car = building.bank.cars[0];
+    for ([[maybe_unused]] auto _ : state) {
+        car.currentState = ElevatorState::IDLE;
+        car.currentDirection = Direction::NONE;
+        building.bank.DecideNextMove(car);
+        building.bank.DecideNextMove(car);
+    }
+    state.SetItemsProcessed(state.Iterations() * 2);
+}
+
+template <class Shape>
+void BM_FourFloorStep(BenchmarkState& state) {
+    size_t count = (size_t)state.Range(0);
+    SmallBuilding<Shape> building(count);
+    vector<pair<int, int>> refill = RandomTrips(FourFloorShape::FLOOR_COUNT, 4096, 7);
+    size_t next = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        building.clock.Advance(TICK_DURATION);
+        building.bank.MoveElevator();
+        while (building.bank.PassengersInSystem() < count) {
+            const auto& trip = refill[next++ & 4095];
+            building.bank.AddPassenger(trip.first, trip.second);
+        }
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+// Kabina mieszcząca wszystkich czekających na parterze, zatrzymana z otwartymi drzwiami.
+unique_ptr<Building> LoadedLobby(size_t count, BoardingKernel kernel) {
+    BuildingConfig config = MakeConfig(20, 1);
+    config.maxWeight = config.weightPerPerson * count;
+    config.boardingKernel = kernel;
+    auto building = make_unique<Building>(config);
+    ElevatorBank& bank = building->bank;
+    bank.Reserve(count);
+    for (size_t i = 0; i < count; ++i) bank.AddPassenger(config.GroundFloor(), 0);
+    building->clock.Advance(TICK_DURATION);
+    bank.MoveElevator();
+    building->clock.Advance(config.doorOpenDuration + TICK_DURATION);
+    return building;
+}
+
+// Od otwarcia drzwi do wejścia ostatniej osoby: StartBoarding, animacja i FinishBoarding.
+void BM_Boarding(BenchmarkState& state) {
+    size_t count = (size_t)state.Range(0);
+    BoardingKernel kernel = (BoardingKernel)state.Range(1);
+    unique_ptr<Building> building;
+    uint64_t boarded = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        state.PauseTiming();
+        building.reset();
+        building = LoadedLobby(count, kernel);
+        state.ResumeTiming();
+        const Elevator& car = building->bank.cars[0];
+        do {
+            building->clock.Advance(TICK_DURATION);
+            building->bank.MoveElevator();
+        } while (car.boardingPassengers > 0);
+        boarded += car.passengersInside;
+    }
+    state.SetItemsProcessed(boarded);
+}
+
+// Postój na piętrze docelowym wszystkich jadących: Alight dla każdego z nich.
+void BM_Alighting(BenchmarkState& state) {
+    size_t count = (size_t)state.Range(0);
+    unique_ptr<Building> building;
+    uint64_t alighted = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        state.PauseTiming();
+        building.reset();
+        building = LoadedLobby(count, BoardingKernel::AOS);
+        ElevatorBank& bank = building->bank;
+        Elevator& car = bank.cars[0];
+        do {
+            building->clock.Advance(TICK_DURATION);
+            bank.MoveElevator();
+        } while (car.boardingPassengers > 0);
+        car.elevatorY = 0.0f;
+        building->clock.Advance(TICK_DURATION);
+        bank.MoveElevator();
+        building->clock.Advance(bank.config.doorOpenDuration + TICK_DURATION);
+        int delivered = bank.deliveredPassengers;
+        state.ResumeTiming();
+        bank.MoveElevator();
+        alighted += bank.deliveredPassengers - delivered;
+    }
+    state.SetItemsProcessed(alighted);
+}
+
+// Godzina ruchu w symulacji zdarzeniowej z dyspozytorem eta.
+void RunTraffic(BenchmarkState& state, TrafficPattern pattern) {
+    BuildingConfig config = MakeConfig((int)state.Range(0), (int)state.Range(1));
+    uint64_t arrivals = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        state.PauseTiming();
+        auto building = make_unique<Building>(config, "eta");
+        TrafficGenerator source(pattern, config.floorCount, (double)state.Range(2), 3600 * 1000, 5);
+        EventScheduler scheduler(building->bank, building->clock);
+        state.ResumeTiming();
+        scheduler.SetArrivalSource(&source);
+        scheduler.Run();
+        arrivals += building->bank.nextPassengerId;
+        state.PauseTiming();
+        building.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(arrivals);
+}
+
+void BM_UpPeak(BenchmarkState& state) { RunTraffic(state, TrafficPattern::UP_PEAK); }
+void BM_DownPeak(BenchmarkState& state) { RunTraffic(state, TrafficPattern::DOWN_PEAK); }
+void BM_Interfloor(BenchmarkState& state) { RunTraffic(state, TrafficPattern::INTERFLOOR); }
+
+// Ruch między piętrami z włączonym dziennikiem zdarzeń (porównanie z BM_Interfloor).
+void BM_InterfloorLogged(BenchmarkState& state) {
+    StartEventLog(1u << 20);
+    RunTraffic(state, TrafficPattern::INTERFLOOR);
+    StopEventLog();
+}
+
+// Jeden rekord dziennika (RecordEvent) przy włączonym (enabled:1) i wyłączonym dzienniku.
+void BM_EventLogRecord(BenchmarkState& state) {
+    if (state.Range(0)) StartEventLog(1u << 16);
+    uint32_t time = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        RecordEvent(LogEvent::BOARD, time, 1, 5, (int)time);
+        time++;
+    }
+    StopEventLog();
+    state.SetItemsProcessed(state.Iterations());
+}
+
+BENCHMARK(BM_AddPassenger)->ArgsProduct({ PASSENGER_COUNTS, FLOOR_COUNTS })->ArgNames({ "passengers", "floors" });
+BENCHMARK(BM_AddPassengerGroups)->ArgsProduct({ { 100000 }, { 1, 10, 100 } })->ArgNames({ "passengers", "group" });
+BENCHMARK(BM_DecideNextMove)->ArgsProduct({ PASSENGER_COUNTS, FLOOR_COUNTS })->ArgNames({ "passengers", "floors" });
+BENCHMARK(BM_MoveElevator)->ArgsProduct({ PASSENGER_COUNTS, FLOOR_COUNTS })->ArgNames({ "passengers", "floors" });
+BENCHMARK(BM_FourFloorDecide<RuntimeBuilding>)->Args({ 10 })->Args({ 1000 })->ArgNames({ "passengers" });
+BENCHMARK(BM_FourFloorDecide<FourFloorBuilding>)->Args({ 10 })->Args({ 1000 })->ArgNames({ "passengers" });
+BENCHMARK(BM_FourFloorStep<RuntimeBuilding>)->Args({ 10 })->Args({ 1000 })->ArgNames({ "passengers" });
+BENCHMARK(BM_FourFloorStep<FourFloorBuilding>)->Args({ 10 })->Args({ 1000 })->ArgNames({ "passengers" });
+BENCHMARK(BM_Boarding)
+    ->ArgsProduct({ BOARDING_COUNTS, { (int64_t)BoardingKernel::AOS, (int64_t)BoardingKernel::SCALAR } })
+    ->ArgNames({ "passengers", "kernel" });
+BENCHMARK(BM_Alighting)->ArgsProduct({ BOARDING_COUNTS })->ArgNames({ "passengers" });
+BENCHMARK(BM_UpPeak)->Args({ 20, 4, 1200 })->Args({ 200, 16, 3000 })->ArgNames({ "floors", "cars", "rate" });
+BENCHMARK(BM_DownPeak)->Args({ 20, 4, 1200 })->Args({ 200, 16, 3000 })->ArgNames({ "floors", "cars", "rate" });
+BENCHMARK(BM_Interfloor)->Args({ 20, 4, 1200 })->Args({ 200, 16, 3000 })->ArgNames({ "floors", "cars", "rate" });
+BENCHMARK(BM_InterfloorLogged)->Args({ 20, 4, 1200 })->Args({ 200, 16, 3000 })->ArgNames({ "floors", "cars", "rate" });
+BENCHMARK(BM_EventLogRecord)->Args({ 0 })->Args({ 1 })->ArgNames({ "enabled" });
+
+}
+
+// Zestaw pomiarów rdzenia symulacji, od pojedynczych funkcji po godzinę ruchu. --json zapisuje wyniki,
+// --compare porównuje je z zapisanymi wcześniej i kończy się kodem 1 przy regresji większej niż --threshold.
+int main(int argc, char** argv) {
+    return RunBenchmarks(argc, argv);
+}
@@ -0,0 +1,85 @@
+﻿#include "SimulationThread.h"
+
+#include <chrono>
+
+#include "Dispatcher.h"
+
+using namespace std;
+
+SimulationThread::SimulationThread(const BuildingConfig& config, unique_ptr<Dispatcher> dispatcher)
+    : bank(clock, config, move(dispatcher)) {
+    Publish(1.0);
+}
+
+SimulationThread::~SimulationThread() {
+    Stop();
+}
+
+void SimulationThread::Start() {
+    if (running.exchange(true)) return;
+    thread = std::thread(&SimulationThread::Run, this);
+}
+
+void SimulationThread::Stop() {
+    running.store(false);
+    if (thread.joinable()) thread.join();
+}
+
+void SimulationThread::Publish(double currentSpeed) {
+    SceneState& state = states.WriteBuffer();
+    CaptureScene(bank, perFloor.load(memory_order_relaxed), state);
+    state.speed = currentSpeed;
+    states.Publish();
+}
+
+// Czas symulowany jest liczony od punktu zaczepienia (wallStart, simStart), przesuwanego przy zmianie
+// prędkości i gdy symulacja nie nadąża, żeby nie próbowała potem nadrobić zaległości naraz.
+void SimulationThread::Run() {
+    using Steady = chrono::steady_clock;
+    Steady::time_point wallStart = Steady::now();
+    uint64_t simStart = clock.Now();
+    uint64_t simTime = simStart;
+    double currentSpeed = speed.load(memory_order_relaxed);
+    Steady::time_point nextPublish = wallStart;
+    bool changed = true;
+
+    while (running.load(memory_order_acquire)) {
+        HallCall call;
+        while (calls.Pop(call)) {
+            bank.AddPassengers(call.startFloor, call.targetFloor, call.count, clock.Now());
+            changed = true;
+        }
+
+        Steady::time_point now = Steady::now();
+        double newSpeed = speed.load(memory_order_relaxed);
+        if (newSpeed != currentSpeed) {
+            wallStart = now;
+            simStart = simTime;
+            currentSpeed = newSpeed;
+            changed = true;
+        }
+        uint64_t target = simStart + (uint64_t)(chrono::duration<double, milli>(now - wallStart).count() * currentSpeed);
+        int stepCount = 0;
+        while (simTime + TICK_DURATION <= target && stepCount < MAX_STEPS_PER_PASS) {
+            clock.Advance(TICK_DURATION);
+            bank.MoveElevator();
+            simTime += TICK_DURATION;
+            stepCount++;
+        }
+        if (stepCount == MAX_STEPS_PER_PASS) {
+            wallStart = now;
+            simStart = simTime;
+        }
+        if (stepCount > 0) {
+            steps.fetch_add(stepCount, memory_order_relaxed);
+            changed = true;
+        }
+
+        if (changed && now >= nextPublish) {
+            Publish(currentSpeed);
+            nextPublish = now + chrono::milliseconds(PUBLISH_INTERVAL_MS);
+            changed = false;
+        }
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+}
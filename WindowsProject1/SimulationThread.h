@@ -0,0 +1,64 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "Scene.h"
+#include "Simulation.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+struct HallCall {
+    int startFloor;
+    int targetFloor;
+    int count;
+};
+
+// Symulacja we własnym wątku, z czasem symulowanym biegnącym speed razy szybciej niż rzeczywisty.
+// Wezwania przychodzą przez kolejkę bez blokad, a stan do narysowania wychodzi przez potrójny bufor,
+// więc wątek okna nigdy nie czeka na krok symulacji i odwrotnie. Call, SetSpeed, SetPassengersPerFloor,
+// Update i Latest wywołuje jeden wątek (okna).
+class SimulationThread {
+public:
+    // Stan jest publikowany nie częściej niż co PUBLISH_INTERVAL_MS, i tylko gdy się zmienił.
+    static constexpr int PUBLISH_INTERVAL_MS = 8;
+    // Gdy krok symulacji nie nadąża, czas symulowany zostaje w tyle zamiast nadrabiać.
+    static constexpr int MAX_STEPS_PER_PASS = 4096;
+
+    explicit SimulationThread(const BuildingConfig& config, std::unique_ptr<Dispatcher> dispatcher = nullptr);
+    ~SimulationThread();
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void Start();
+    void Stop();
+
+    // count osób z jednego wezwania. Zwraca false, gdy kolejka wezwań jest pełna.
+    bool Call(int startFloor, int targetFloor, int count = 1) { return calls.Push({ startFloor, targetFloor, count }); }
+    void SetSpeed(double speed) { this->speed.store(speed, std::memory_order_relaxed); }
+    double Speed() const { return speed.load(std::memory_order_relaxed); }
+    void SetPassengersPerFloor(size_t perFloor) { this->perFloor.store(perFloor, std::memory_order_relaxed); }
+
+    // Zwraca true, jeśli pojawił się nowy stan; Latest zwraca ostatni odebrany.
+    bool Update() { return states.Update(); }
+    const SceneState& Latest() const { return states.ReadBuffer(); }
+    const BuildingConfig& Config() const { return bank.config; }
+    uint64_t Steps() const { return steps.load(std::memory_order_relaxed); }
+
+private:
+    void Run();
+    void Publish(double currentSpeed);
+
+    ManualClock clock;
+    ElevatorBank bank;
+    TripleBuffer<SceneState> states;
+    SpscQueue<HallCall, 1024> calls;
+    std::atomic<double> speed{ 1.0 };
+    std::atomic<size_t> perFloor{ 64 };
+    std::atomic<bool> running{ false };
+    std::atomic<uint64_t> steps{ 0 };
+    std::thread thread;
+};
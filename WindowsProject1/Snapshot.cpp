@@ -0,0 +1,623 @@
+﻿#include "Snapshot.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "Dispatcher.h"
+
+using namespace std;
+
+static uint64_t Fnv1a(const uint8_t* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static void PutU32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint32_t GetU32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(vector<uint8_t>& out) : out(out) {}
+
+    void Unsigned(uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((uint8_t)value);
+    }
+    void Signed(int64_t value) { Unsigned(((uint64_t)value << 1) ^ (uint64_t)(value >> 63)); }
+    void Float(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        size_t at = out.size();
+        out.resize(at + 4);
+        PutU32(&out[at], bits);
+    }
+    void Double(double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        size_t at = out.size();
+        out.resize(at + 8);
+        PutU32(&out[at], (uint32_t)bits);
+        PutU32(&out[at + 4], (uint32_t)(bits >> 32));
+    }
+    void String(const string& value) {
+        Unsigned(value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+private:
+    vector<uint8_t>& out;
+};
+
+// Po pierwszym błędzie (koniec danych, wartość poza zakresem) wszystkie odczyty zwracają 0.
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, size_t size) : p(data), end(data + size) {}
+
+    bool Ok() const { return ok; }
+    bool AtEnd() const { return p == end; }
+    void Fail() { ok = false; }
+
+    uint64_t Unsigned() {
+        uint64_t value = 0;
+        for (int shift = 0; ok && shift < 64; shift += 7) {
+            if (p == end) break;
+            uint8_t byte = *p++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+    int64_t Signed() {
+        uint64_t value = Unsigned();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+    // Wartość bez znaku nie większa niż high.
+    uint64_t Unsigned(uint64_t high) {
+        uint64_t value = Unsigned();
+        if (value > high) ok = false;
+        return ok ? value : 0;
+    }
+    // Wartość ze znakiem z przedziału [low, high].
+    int64_t Int(int64_t low, int64_t high) {
+        int64_t value = Signed();
+        if (value < low || value > high) ok = false;
+        return ok ? value : low;
+    }
+    // Długość tablicy, w której każdy element zajmuje co najmniej jeden bajt.
+    size_t Count() {
+        uint64_t value = Unsigned();
+        if (value > (uint64_t)(end - p)) ok = false;
+        return ok ? (size_t)value : 0;
+    }
+    float Float() {
+        if (end - p < 4) {
+            ok = false;
+            return 0.0f;
+        }
+        uint32_t bits = GetU32(p);
+        p += 4;
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    double Double() {
+        if (end - p < 8) {
+            ok = false;
+            return 0.0;
+        }
+        uint64_t bits = GetU32(p) | (uint64_t)GetU32(p + 4) << 32;
+        p += 8;
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    string String() {
+        size_t size = Count();
+        string value((const char*)p, size);
+        p += size;
+        return value;
+    }
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+};
+
+// Zapis i odczyt pól prywatnych ElevatorBank i Histogram.
+struct SnapshotAccess {
+    static void WriteConfig(SnapshotWriter& out, const BuildingConfig& config);
+    static BuildingConfig ReadConfig(SnapshotReader& in, uint32_t version);
+    static void WriteHistogram(SnapshotWriter& out, const Histogram& histogram);
+    static void ReadHistogram(SnapshotReader& in, Histogram& histogram);
+    static void WriteDemand(SnapshotWriter& out, const DemandModel& demand);
+    static void ReadDemand(SnapshotReader& in, DemandModel& demand);
+    static void WriteBank(SnapshotWriter& out, const ElevatorBank& bank);
+    static void ReadBank(SnapshotReader& in, ElevatorBank& bank, uint32_t version);
+};
+
+void SnapshotAccess::WriteConfig(SnapshotWriter& out, const BuildingConfig& config) {
+    out.Signed(config.floorCount);
+    out.Signed(config.floorHeight);
+    out.Float(config.maxWeight);
+    out.Float(config.weightPerPerson);
+    out.Float(config.elevatorSpeed);
+    out.Unsigned(config.doorOpenDuration);
+    out.Signed(config.fullElevatorThreshold);
+    out.Unsigned(config.idleReturnDelay);
+    out.Signed(config.carCount);
+    out.Unsigned((uint64_t)config.boardingKernel);
+    out.Unsigned((uint64_t)config.motionModel);
+    out.Float(config.floorHeightMeters);
+    out.Float(config.ratedSpeed);
+    out.Float(config.acceleration);
+    out.Float(config.jerk);
+    out.Unsigned((uint64_t)config.parkingPolicy);
+    out.Unsigned(config.demandHalfLife);
+    out.Unsigned(config.demandSlot);
+    out.Unsigned(config.zones.size());
+    for (const auto& zone : config.zones) {
+        out.Signed(zone.firstCar);
+        out.Signed(zone.lastCar);
+        out.Unsigned(zone.doubleDeck ? 1 : 0);
+        out.Unsigned(zone.floors.size());
+        for (int label : zone.floors) out.Signed(label);
+    }
+    out.Signed(config.stairsFloors);
+    out.Signed(config.balkQueue);
+    out.Unsigned(config.patience);
+    out.Float(config.walkSpeed);
+}
+
+BuildingConfig SnapshotAccess::ReadConfig(SnapshotReader& in, uint32_t version) {
+    BuildingConfig config;
+    config.floorCount = (int)in.Int(INT32_MIN, INT32_MAX);
+    config.floorHeight = (int)in.Int(INT32_MIN, INT32_MAX);
+    config.maxWeight = in.Float();
+    config.weightPerPerson = in.Float();
+    config.elevatorSpeed = in.Float();
+    config.doorOpenDuration = (uint32_t)in.Unsigned(UINT32_MAX);
+    config.fullElevatorThreshold = (int)in.Int(INT32_MIN, INT32_MAX);
+    config.idleReturnDelay = (uint32_t)in.Unsigned(UINT32_MAX);
+    config.carCount = (int)in.Int(INT32_MIN, INT32_MAX);
+    config.boardingKernel = (BoardingKernel)in.Unsigned((int)BoardingKernel::AUTO);
+    if (version >= 2) {
+        config.motionModel = (MotionModel)in.Unsigned((int)MotionModel::JERK);
+        config.floorHeightMeters = in.Float();
+        config.ratedSpeed = in.Float();
+        config.acceleration = in.Float();
+        config.jerk = in.Float();
+    }
+    if (version >= 4) {
+        config.parkingPolicy = (ParkingPolicy)in.Unsigned((int)ParkingPolicy::DEMAND);
+        config.demandHalfLife = (uint32_t)in.Unsigned(UINT32_MAX);
+        config.demandSlot = (uint32_t)in.Unsigned(UINT32_MAX);
+    }
+    if (version >= 5) {
+        size_t zones = in.Count();
+        for (size_t i = 0; i < zones && in.Ok(); ++i) {
+            CarZone zone;
+            zone.firstCar = (int)in.Int(0, INT32_MAX);
+            zone.lastCar = (int)in.Int(0, INT32_MAX);
+            zone.doubleDeck = in.Unsigned(1) != 0;
+            size_t floors = in.Count();
+            for (size_t f = 0; f < floors && in.Ok(); ++f) zone.floors.push_back((int)in.Int(0, INT32_MAX));
+            config.zones.push_back(zone);
+        }
+    }
+    if (version >= 6) {
+        config.stairsFloors = (int)in.Int(0, INT32_MAX);
+        config.balkQueue = (int)in.Int(0, INT32_MAX);
+        config.patience = (uint32_t)in.Unsigned(UINT32_MAX);
+        config.walkSpeed = in.Float();
+    }
+    return config;
+}
+
+// Zapisywane są tylko niezerowe kubełki: odstęp od poprzedniego i liczba.
+void SnapshotAccess::WriteHistogram(SnapshotWriter& out, const Histogram& histogram) {
+    size_t used = 0;
+    for (uint64_t c : histogram.counts) used += c != 0;
+    out.Unsigned(used);
+    int previous = -1;
+    for (int i = 0; i < (int)histogram.counts.size(); ++i) {
+        if (!histogram.counts[i]) continue;
+        out.Unsigned(i - previous);
+        out.Unsigned(histogram.counts[i]);
+        previous = i;
+    }
+    out.Unsigned(histogram.count);
+    out.Unsigned(histogram.sum);
+    out.Unsigned(histogram.max);
+}
+
+void SnapshotAccess::ReadHistogram(SnapshotReader& in, Histogram& histogram) {
+    size_t used = in.Count();
+    int index = -1;
+    for (size_t i = 0; i < used && in.Ok(); ++i) {
+        index += (int)in.Unsigned(Histogram::BUCKET_COUNT);
+        if (index >= Histogram::BUCKET_COUNT) in.Fail();
+        else histogram.counts[index] = in.Unsigned();
+    }
+    histogram.count = in.Unsigned();
+    histogram.sum = in.Unsigned();
+    histogram.max = (uint32_t)in.Unsigned(UINT32_MAX);
+}
+
+// Tablice modelu mają rozmiar wynikający z konfiguracji (już odtworzonej), więc długości są tylko sprawdzane.
+static void WriteCounts(SnapshotWriter& out, const vector<double>& values) {
+    out.Unsigned(values.size());
+    for (double value : values) out.Double(value);
+}
+
+static void ReadCounts(SnapshotReader& in, vector<double>& values) {
+    if (in.Count() != values.size()) in.Fail();
+    for (double& value : values) value = in.Double();
+}
+
+void SnapshotAccess::WriteDemand(SnapshotWriter& out, const DemandModel& demand) {
+    out.Unsigned(demand.recent.base);
+    WriteCounts(out, demand.recent.values);
+    out.Double(demand.recentTotal);
+    out.Unsigned(demand.slots.base);
+    WriteCounts(out, demand.slots.values);
+    WriteCounts(out, demand.slotTotals);
+    WriteCounts(out, demand.slotLast);
+}
+
+void SnapshotAccess::ReadDemand(SnapshotReader& in, DemandModel& demand) {
+    demand.recent.base = (uint32_t)in.Unsigned(UINT32_MAX);
+    ReadCounts(in, demand.recent.values);
+    demand.recentTotal = in.Double();
+    demand.slots.base = (uint32_t)in.Unsigned(UINT32_MAX);
+    ReadCounts(in, demand.slots.values);
+    ReadCounts(in, demand.slotTotals);
+    ReadCounts(in, demand.slotLast);
+}
+
+static void WriteList(SnapshotWriter& out, const PassengerList& list) {
+    out.Signed(list.head);
+    out.Signed(list.tail);
+    out.Unsigned(list.size);
+}
+
+static void ReadList(SnapshotReader& in, PassengerList& list, int slots) {
+    list.head = (int)in.Int(-1, slots - 1);
+    list.tail = (int)in.Int(-1, slots - 1);
+    list.size = (int)in.Unsigned(slots);
+}
+
+static void WriteRequests(SnapshotWriter& out, const FloorRequests& requests) {
+    for (int count : requests.count) out.Unsigned(count);
+}
+
+static void ReadRequests(SnapshotReader& in, FloorRequests& requests) {
+    for (size_t floor = 0; floor < requests.count.size(); ++floor) {
+        requests.count[floor] = (int)in.Unsigned(INT32_MAX);
+        if (requests.count[floor] > 0) requests.floors.Set((int)floor);
+    }
+}
+
+static void WriteIndices(SnapshotWriter& out, const vector<int>& values) {
+    out.Unsigned(values.size());
+    for (int value : values) out.Signed(value);
+}
+
+static void ReadIndices(SnapshotReader& in, vector<int>& values, int slots) {
+    values.resize(in.Count());
+    for (int& value : values) value = (int)in.Int(0, slots - 1);
+}
+
+// Pola listowe pasażerów (prev, next, posIndex) i wolne miejsca są zapisywane wprost,
+// więc kolejność na listach i ponowne użycie miejsc po odtworzeniu są takie same.
+void SnapshotAccess::WriteBank(SnapshotWriter& out, const ElevatorBank& bank) {
+    out.Unsigned(bank.passengers.size());
+    for (const auto& p : bank.passengers) {
+        out.Signed(p.id);
+        out.Signed(p.startFloor);
+        out.Signed(p.targetFloor);
+        out.Signed(p.car);
+        out.Unsigned(p.arrivalTime);
+        out.Unsigned(p.boardTime);
+        out.Unsigned((p.inElevator ? 1 : 0) | (p.boarding ? 2 : 0) | (p.transferred ? 4 : 0));
+        out.Signed(p.finalFloor);
+        out.Float(p.animX);
+        out.Float(p.animY);
+        out.Float(p.boardingProgress);
+        out.Signed(p.posIndex);
+        out.Signed(p.prev);
+        out.Signed(p.next);
+    }
+    // Wolne miejsca od zwolnionego najdawniej, czekający w holu w kolejności pozycji.
+    vector<int> indices;
+    for (int slot = bank.freeHead; slot != -1; slot = bank.passengers[slot].next) indices.push_back(slot);
+    reverse(indices.begin(), indices.end());
+    WriteIndices(out, indices);
+    for (const auto& lobby : bank.lobbies) {
+        indices.clear();
+        for (int slot = lobby.head; slot != -1; slot = bank.passengers[slot].lobbyNext) indices.push_back(slot);
+        WriteIndices(out, indices);
+    }
+    out.Signed(bank.nextPassengerId);
+    out.Signed(bank.deliveredPassengers);
+
+    for (const auto& car : bank.cars) {
+        out.Unsigned((uint64_t)car.currentState);
+        out.Unsigned((uint64_t)car.currentDirection);
+        out.Float(car.elevatorY);
+        out.Signed(car.targetFloor);
+        out.Unsigned(car.stateTimer);
+        out.Unsigned(car.tripStart);
+        out.Float(car.tripStartY);
+        out.Signed(car.assignedPassengers);
+        out.Signed(car.passengersInside);
+        for (const FloorRequests* requests : { &car.destinations, &car.upRequests, &car.downRequests, &car.waitingUp, &car.waitingDown }) {
+            WriteRequests(out, *requests);
+        }
+        out.Signed(car.hallCalls);
+        out.Signed(car.boardingPassengers);
+        for (const vector<PassengerList>* lists : { &car.queueUp, &car.queueDown, &car.riders }) {
+            for (const auto& list : *lists) WriteList(out, list);
+        }
+        WriteList(out, car.boarding);
+        WriteIndices(out, car.occupants);
+    }
+
+    const BoardingBatch& batch = bank.boardingBatch;
+    out.Unsigned(batch.Size());
+    for (size_t i = 0; i < batch.Size(); ++i) {
+        out.Signed(batch.slot[i]);
+        out.Float(batch.x[i]);
+        out.Float(batch.y[i]);
+    }
+
+    const SimulationMetrics& metrics = bank.metrics;
+    for (const Histogram* histogram : { &metrics.wait, &metrics.ride, &metrics.journey }) WriteHistogram(out, *histogram);
+    for (const auto& stats : metrics.cars) {
+        out.Unsigned(stats.stops);
+        out.Unsigned(stats.trips);
+        out.Unsigned(stats.reversals);
+        out.Unsigned(stats.floorsTravelled);
+        out.Unsigned(stats.passengerFloors);
+        out.Signed(stats.lastStopFloor);
+        out.Signed(stats.lastTravelDirection);
+    }
+    out.Unsigned(bank.digest.value);
+    out.Unsigned(bank.digest.events);
+    WriteDemand(out, bank.demand);
+    out.Unsigned(metrics.windowStart);
+    out.Unsigned(metrics.windowDelivered);
+    out.Unsigned(metrics.bestWindow);
+    out.Unsigned(bank.transfers);
+    out.Unsigned(bank.patienceTimers.size());
+    for (const auto& timer : bank.patienceTimers) {
+        out.Unsigned(timer.deadline);
+        out.Signed(timer.slot);
+        out.Signed(timer.id);
+    }
+    out.Unsigned(bank.reneged);
+    out.Unsigned(bank.balked);
+    out.Unsigned(bank.walked);
+}
+
+void SnapshotAccess::ReadBank(SnapshotReader& in, ElevatorBank& bank, uint32_t version) {
+    const BuildingConfig& config = bank.config;
+    int floors = config.floorCount;
+    bank.passengers.resize(in.Count());
+    int slots = (int)bank.passengers.size();
+    for (auto& p : bank.passengers) {
+        p.id = (int)in.Int(0, INT32_MAX);
+        p.startFloor = (int)in.Int(0, floors - 1);
+        p.targetFloor = (int)in.Int(0, floors - 1);
+        p.car = (int)in.Int(0, (int)bank.cars.size() - 1);
+        p.arrivalTime = (uint32_t)in.Unsigned(UINT32_MAX);
+        p.boardTime = (uint32_t)in.Unsigned(UINT32_MAX);
+        int flags = (int)in.Unsigned(version >= 5 ? 7 : 3);
+        p.inElevator = (flags & 1) != 0;
+        p.boarding = (flags & 2) != 0;
+        p.transferred = (flags & 4) != 0;
+        if (version >= 5) p.finalFloor = (int)in.Int(-1, floors - 1);
+        p.animX = in.Float();
+        p.animY = in.Float();
+        p.boardingProgress = in.Float();
+        p.posIndex = (int)in.Int(0, INT32_MAX);
+        p.prev = (int)in.Int(-1, slots - 1);
+        p.next = (int)in.Int(-1, slots - 1);
+    }
+    vector<int> indices;
+    ReadIndices(in, indices, slots);
+    for (int slot : indices) bank.FreeSlot(slot);
+    for (auto& lobby : bank.lobbies) {
+        ReadIndices(in, indices, slots);
+        for (int slot : indices) bank.JoinLobby(lobby, slot);
+    }
+    bank.nextPassengerId = (int)in.Int(0, INT32_MAX);
+    bank.deliveredPassengers = (int)in.Int(0, INT32_MAX);
+
+    for (auto& car : bank.cars) {
+        car.currentState = (ElevatorState)in.Unsigned((int)ElevatorState::STOPPED);
+        car.currentDirection = (Direction)in.Unsigned((int)Direction::NONE);
+        car.elevatorY = in.Float();
+        car.targetFloor = (int)in.Int(-1, floors - 1);
+        car.stateTimer = (uint32_t)in.Unsigned(UINT32_MAX);
+        if (version >= 2) {
+            car.tripStart = (uint32_t)in.Unsigned(UINT32_MAX);
+            car.tripStartY = in.Float();
+        }
+        // Profil przejazdu wynika ze startu i celu, więc jest liczony od nowa.
+        if (config.motionModel == MotionModel::JERK && car.currentState == ElevatorState::MOVING && car.targetFloor != -1) {
+            bank.PlanTrip(car);
+        }
+        car.assignedPassengers = (int)in.Int(0, slots);
+        car.passengersInside = (int)in.Int(0, slots);
+        for (FloorRequests* requests : { &car.destinations, &car.upRequests, &car.downRequests, &car.waitingUp, &car.waitingDown }) {
+            ReadRequests(in, *requests);
+        }
+        car.hallCalls = (int)in.Int(0, slots);
+        car.boardingPassengers = (int)in.Int(0, slots);
+        for (vector<PassengerList>* lists : { &car.queueUp, &car.queueDown, &car.riders }) {
+            for (auto& list : *lists) ReadList(in, list, slots);
+        }
+        ReadList(in, car.boarding, slots);
+        ReadIndices(in, car.occupants, slots);
+    }
+
+    BoardingBatch& batch = bank.boardingBatch;
+    size_t boarding = in.Count();
+    for (size_t i = 0; i < boarding && in.Ok(); ++i) {
+        int slot = (int)in.Int(0, slots - 1);
+        float x = in.Float();
+        float y = in.Float();
+        batch.Add(slot, x, y);
+    }
+
+    SimulationMetrics& metrics = bank.metrics;
+    for (Histogram* histogram : { &metrics.wait, &metrics.ride, &metrics.journey }) ReadHistogram(in, *histogram);
+    for (auto& stats : metrics.cars) {
+        stats.stops = in.Unsigned();
+        stats.trips = in.Unsigned();
+        stats.reversals = in.Unsigned();
+        stats.floorsTravelled = in.Unsigned();
+        stats.passengerFloors = in.Unsigned();
+        stats.lastStopFloor = (int)in.Int(-1, floors - 1);
+        stats.lastTravelDirection = (int)in.Int(-1, 1);
+    }
+    if (version >= 3) {
+        bank.digest.value = in.Unsigned();
+        bank.digest.events = in.Unsigned();
+    }
+    if (version >= 4) ReadDemand(in, bank.demand);
+    if (version >= 5) {
+        metrics.windowStart = (uint32_t)in.Unsigned(UINT32_MAX);
+        metrics.windowDelivered = (uint32_t)in.Unsigned(UINT32_MAX);
+        metrics.bestWindow = (uint32_t)in.Unsigned(UINT32_MAX);
+        bank.transfers = in.Unsigned();
+    }
+    if (version >= 6) {
+        size_t timers = in.Count();
+        for (size_t i = 0; i < timers && in.Ok(); ++i) {
+            uint32_t deadline = (uint32_t)in.Unsigned(UINT32_MAX);
+            int slot = (int)in.Int(0, slots - 1);
+            int id = (int)in.Int(0, INT32_MAX);
+            bank.patienceTimers.push_back({ deadline, slot, id });
+        }
+        // Kopiec jest zapisany w swojej kolejności; make_heap porządkuje też pliki z terminami w kolejności przyjść.
+        make_heap(bank.patienceTimers.begin(), bank.patienceTimers.end(), ElevatorBank::PatienceLater());
+        bank.reneged = in.Unsigned();
+        bank.balked = in.Unsigned();
+        bank.walked = in.Unsigned();
+    }
+}
+
+void EncodeSnapshot(const ElevatorBank& bank, const RunPosition& position, vector<uint8_t>& out) {
+    out.assign(SNAPSHOT_HEADER_SIZE, 0);
+    memcpy(out.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    PutU32(&out[8], SNAPSHOT_VERSION);
+
+    SnapshotWriter writer(out);
+    SnapshotAccess::WriteConfig(writer, bank.config);
+    writer.String(bank.dispatcher->Name());
+    writer.Unsigned(bank.clock.Now());
+    writer.Unsigned(position.arrivalsTaken);
+    writer.Unsigned(position.changedCars.size());
+    for (uint8_t changed : position.changedCars) writer.Unsigned(changed);
+    SnapshotAccess::WriteBank(writer, bank);
+
+    size_t bodySize = out.size() - SNAPSHOT_HEADER_SIZE;
+    PutU32(&out[12], (uint32_t)bodySize);
+    uint64_t hash = Fnv1a(out.data() + SNAPSHOT_HEADER_SIZE, bodySize);
+    for (int i = 0; i < 8; ++i) out.push_back((uint8_t)(hash >> (8 * i)));
+}
+
+unique_ptr<ElevatorBank> DecodeSnapshot(const uint8_t* data, size_t size, ManualClock& clock, RunPosition& position, string& error) {
+    if (size < SNAPSHOT_HEADER_SIZE + 8 || memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        error = "to nie jest plik stanu symulacji";
+        return nullptr;
+    }
+    uint32_t version = GetU32(data + 8);
+    if (version < 1 || version > SNAPSHOT_VERSION) {
+        error = "nieobsługiwana wersja pliku stanu " + to_string(version);
+        return nullptr;
+    }
+    size_t bodySize = GetU32(data + 12);
+    if (bodySize != size - SNAPSHOT_HEADER_SIZE - 8) {
+        error = "plik stanu jest obcięty";
+        return nullptr;
+    }
+    const uint8_t* body = data + SNAPSHOT_HEADER_SIZE;
+    uint64_t hash = 0;
+    for (int i = 0; i < 8; ++i) hash |= (uint64_t)body[bodySize + i] << (8 * i);
+    if (hash != Fnv1a(body, bodySize)) {
+        error = "błędna suma kontrolna pliku stanu";
+        return nullptr;
+    }
+
+    SnapshotReader reader(body, bodySize);
+    BuildingConfig config = SnapshotAccess::ReadConfig(reader, version);
+    if (!reader.Ok() || !ValidateBuildingConfig(config, error)) {
+        if (error.empty()) error = "uszkodzona konfiguracja w pliku stanu";
+        return nullptr;
+    }
+    string dispatcherName = reader.String();
+    unique_ptr<Dispatcher> dispatcher = CreateDispatcher(dispatcherName);
+    if (!dispatcher) {
+        error = "nieznany dyspozytor w pliku stanu: " + dispatcherName;
+        return nullptr;
+    }
+    clock.Set((uint32_t)reader.Unsigned(UINT32_MAX));
+    position.arrivalsTaken = reader.Unsigned();
+    position.changedCars.resize(reader.Count());
+    for (uint8_t& changed : position.changedCars) changed = (uint8_t)reader.Unsigned(1);
+
+    auto bank = make_unique<ElevatorBank>(clock, config, move(dispatcher));
+    SnapshotAccess::ReadBank(reader, *bank, version);
+    if (!reader.Ok() || !reader.AtEnd()) {
+        error = "uszkodzony stan w pliku stanu";
+        return nullptr;
+    }
+    return bank;
+}
+
+bool SaveSnapshot(const string& path, const ElevatorBank& bank, const RunPosition& position, string& error) {
+    vector<uint8_t> data;
+    EncodeSnapshot(bank, position, data);
+    FILE* out = fopen(path.c_str(), "wb");
+    if (!out) {
+        error = "nie można zapisać pliku " + path;
+        return false;
+    }
+    bool written = fwrite(data.data(), 1, data.size(), out) == data.size();
+    if (fclose(out) != 0 || !written) {
+        error = "błąd zapisu pliku " + path;
+        return false;
+    }
+    return true;
+}
+
+unique_ptr<ElevatorBank> LoadSnapshot(const string& path, ManualClock& clock, RunPosition& position, string& error) {
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) {
+        error = "nie można otworzyć pliku " + path;
+        return nullptr;
+    }
+    vector<uint8_t> data;
+    uint8_t buffer[65536];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), in)) > 0) data.insert(data.end(), buffer, buffer + read);
+    fclose(in);
+    return DecodeSnapshot(data.data(), data.size(), clock, position, error);
+}
@@ -0,0 +1,38 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Simulation.h"
+
+// Plik stanu: nagłówek SNAPSHOT_HEADER_SIZE bajtów ("ELVSNAP1", wersja, długość treści), treść i 8 bajtów
+// sumy kontrolnej FNV-1a treści. Liczby całkowite w treści są zapisane jako varint (ujemne zygzakiem),
+// liczby zmiennoprzecinkowe jako 4 bajty little-endian, więc odtworzony stan jest identyczny bit w bit.
+const char SNAPSHOT_MAGIC[8] = { 'E', 'L', 'V', 'S', 'N', 'A', 'P', '1' };
+// Wersja 2 dodała model ruchu i przejazd kabiny; pliki w wersji 1 są wczytywane z modelem CONSTANT.
+// Wersja 3 dodała skrót przebiegu; ze starszych plików skrót liczy się od zera.
+// Wersja 4 dodała politykę postoju i model popytu; starsze pliki są wczytywane z polityką GROUND.
+// Wersja 5 dodała strefy kabin, przesiadki pasażerów i przepustowość; starsze pliki są bez stref.
+// Wersja 6 dodała zachowanie pasażerów (schody, rezygnacje, terminy cierpliwości); starsze pliki są bez niego.
+const uint32_t SNAPSHOT_VERSION = 6;
+const size_t SNAPSHOT_HEADER_SIZE = 16;
+
+// Stan przebiegu poza zespołem wind, potrzebny do jego wznowienia.
+struct RunPosition {
+    // Rekordy pobrane ze strumienia przyjść i dodane do symulacji; przy wznowieniu są pomijane.
+    uint64_t arrivalsTaken = 0;
+    // EventScheduler: kabiny, których stan zmienił się w ostatnim kroku (puste w pętli krokowej).
+    std::vector<uint8_t> changedCars;
+};
+
+// Zapisuje konfigurację, nazwę dyspozytora, czas zegara i cały stan zespołu wind razem z metrykami.
+void EncodeSnapshot(const ElevatorBank& bank, const RunPosition& position, std::vector<uint8_t>& out);
+// Tworzy zespół wind z zapisanego stanu i ustawia zegar na czas zapisu. Zwraca nullptr przy błędzie.
+std::unique_ptr<ElevatorBank> DecodeSnapshot(const uint8_t* data, size_t size, ManualClock& clock,
+    RunPosition& position, std::string& error);
+
+bool SaveSnapshot(const std::string& path, const ElevatorBank& bank, const RunPosition& position, std::string& error);
+std::unique_ptr<ElevatorBank> LoadSnapshot(const std::string& path, ManualClock& clock, RunPosition& position,
+    std::string& error);
@@ -0,0 +1,183 @@
+﻿#include "SoftwareRenderer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+void SoftwareBackend::Resize(int width, int height) {
+    this->width = max(0, width);
+    this->height = max(0, height);
+    frame.assign((size_t)this->width * this->height, MakeArgb(255, 255, 255));
+    background.assign(frame.size(), MakeArgb(255, 255, 255));
+    target = &frame;
+    ResetClip();
+}
+
+void SoftwareBackend::RestoreBackground(const ScreenRect& rect) {
+    ScreenRect r = Intersect(rect, { 0, 0, width, height });
+    for (int y = r.y; y < r.Bottom(); ++y) {
+        size_t row = (size_t)y * width;
+        copy(background.begin() + row + r.x, background.begin() + row + r.Right(), frame.begin() + row + r.x);
+    }
+}
+
+void SoftwareBackend::SetClip(const ScreenRect& rect) {
+    clip = Intersect(rect, { 0, 0, width, height });
+}
+
+void SoftwareBackend::FillSpan(int x0, int x1, int y, Argb color) {
+    if (y < clip.y || y >= clip.Bottom()) return;
+    x0 = max(x0, clip.x);
+    x1 = min(x1, clip.Right() - 1);
+    if (x0 > x1) return;
+    Argb* row = target->data() + (size_t)y * width;
+    fill(row + x0, row + x1 + 1, color);
+}
+
+void SoftwareBackend::FillRectangle(const ScreenRect& rect, Argb color) {
+    ScreenRect r = Intersect(rect, clip);
+    for (int y = r.y; y < r.Bottom(); ++y) FillSpan(r.x, r.Right() - 1, y, color);
+}
+
+static Argb Lerp(Argb a, Argb b, int step, int steps) {
+    Argb result = 0xFF000000u;
+    for (int shift = 0; shift < 24; shift += 8) {
+        int ca = (a >> shift) & 0xFF, cb = (b >> shift) & 0xFF;
+        result |= (uint32_t)(ca + (cb - ca) * step / steps) << shift;
+    }
+    return result;
+}
+
+void SoftwareBackend::FillGradient(const ScreenRect& rect, Argb top, Argb bottom) {
+    ScreenRect r = Intersect(rect, clip);
+    int steps = max(1, rect.height - 1);
+    for (int y = r.y; y < r.Bottom(); ++y) FillSpan(r.x, r.Right() - 1, y, Lerp(top, bottom, y - rect.y, steps));
+}
+
+// Pióro o grubości width leży na środku krawędzi, tak jak w GDI+.
+void SoftwareBackend::DrawRectangle(const ScreenRect& rect, Argb color, int width) {
+    int lo = width / 2;
+    FillRectangle({ rect.x - lo, rect.y - lo, rect.width + width, width }, color);
+    FillRectangle({ rect.x - lo, rect.Bottom() - lo, rect.width + width, width }, color);
+    FillRectangle({ rect.x - lo, rect.y - lo, width, rect.height + width }, color);
+    FillRectangle({ rect.Right() - lo, rect.y - lo, width, rect.height + width }, color);
+}
+
+void SoftwareBackend::DrawLine(int x0, int y0, int x1, int y1, Argb color, int width) {
+    int dx = abs(x1 - x0), dy = -abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    int lo = width / 2;
+    while (true) {
+        for (int y = y0 - lo; y < y0 - lo + width; ++y) FillSpan(x0 - lo, x0 - lo + width - 1, y, color);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+// Piksele wiersza y, których środki leżą w elipsie wpisanej w rect; left > right, gdy żadne.
+void SoftwareBackend::EllipseSpan(const ScreenRect& rect, int y, int& left, int& right) const {
+    left = 1;
+    right = 0;
+    if (rect.Empty()) return;
+    double a = rect.width / 2.0, b = rect.height / 2.0;
+    double dy = (y + 0.5 - (rect.y + b)) / b;
+    if (dy * dy > 1.0) return;
+    double half = a * sqrt(1.0 - dy * dy);
+    double cx = rect.x + a;
+    left = (int)ceil(cx - half - 0.5);
+    right = (int)floor(cx + half - 0.5);
+}
+
+void SoftwareBackend::FillEllipse(const ScreenRect& rect, Argb color) {
+    for (int y = max(rect.y, clip.y); y < min(rect.Bottom(), clip.Bottom()); ++y) {
+        int left, right;
+        EllipseSpan(rect, y, left, right);
+        FillSpan(left, right, y, color);
+    }
+}
+
+void SoftwareBackend::DrawEllipse(const ScreenRect& rect, Argb color, int width) {
+    int lo = width / 2;
+    ScreenRect outer = { rect.x - lo, rect.y - lo, rect.width + width, rect.height + width };
+    ScreenRect inner = { rect.x + width - lo, rect.y + width - lo, rect.width - width, rect.height - width };
+    for (int y = max(outer.y, clip.y); y < min(outer.Bottom(), clip.Bottom()); ++y) {
+        int left, right, innerLeft, innerRight;
+        EllipseSpan(outer, y, left, right);
+        EllipseSpan(inner, y, innerLeft, innerRight);
+        if (innerLeft > innerRight) {
+            FillSpan(left, right, y, color);
+        }
+        else {
+            FillSpan(left, innerLeft - 1, y, color);
+            FillSpan(innerRight + 1, right, y, color);
+        }
+    }
+}
+
+// Czcionka 3x5: pięć wierszy po trzy bity (4 = lewa kolumna). Małe litery i polskie znaki
+// rysowane są jak odpowiednie wielkie litery, pozostałe znaki jako puste miejsce.
+static const uint8_t* Glyph(wchar_t c) {
+    static const uint8_t digits[10][5] = {
+        { 7, 5, 5, 5, 7 }, { 2, 6, 2, 2, 7 }, { 7, 1, 7, 4, 7 }, { 7, 1, 3, 1, 7 }, { 5, 5, 7, 1, 1 },
+        { 7, 4, 7, 1, 7 }, { 7, 4, 7, 5, 7 }, { 7, 1, 1, 2, 2 }, { 7, 5, 7, 5, 7 }, { 7, 5, 7, 1, 7 },
+    };
+    static const uint8_t letters[26][5] = {
+        { 2, 5, 7, 5, 5 }, { 6, 5, 6, 5, 6 }, { 3, 4, 4, 4, 3 }, { 6, 5, 5, 5, 6 }, { 7, 4, 6, 4, 7 },
+        { 7, 4, 6, 4, 4 }, { 3, 4, 5, 5, 3 }, { 5, 5, 7, 5, 5 }, { 7, 2, 2, 2, 7 }, { 1, 1, 1, 5, 2 },
+        { 5, 5, 6, 5, 5 }, { 4, 4, 4, 4, 7 }, { 5, 7, 7, 5, 5 }, { 6, 5, 5, 5, 5 }, { 2, 5, 5, 5, 2 },
+        { 6, 5, 6, 4, 4 }, { 2, 5, 5, 6, 3 }, { 6, 5, 6, 5, 5 }, { 3, 4, 2, 1, 6 }, { 7, 2, 2, 2, 2 },
+        { 5, 5, 5, 5, 7 }, { 5, 5, 5, 5, 2 }, { 5, 5, 7, 7, 5 }, { 5, 5, 2, 5, 5 }, { 5, 5, 2, 2, 2 },
+        { 7, 1, 2, 4, 7 },
+    };
+    static const struct { wchar_t c; uint8_t rows[5]; } symbols[] = {
+        { L'-', { 0, 0, 7, 0, 0 } }, { L'>', { 4, 2, 1, 2, 4 } }, { L'.', { 0, 0, 0, 0, 2 } },
+        { L',', { 0, 0, 0, 2, 4 } }, { L':', { 0, 2, 0, 2, 0 } }, { L'(', { 1, 2, 2, 2, 1 } },
+        { L')', { 4, 2, 2, 2, 4 } }, { L'/', { 1, 1, 2, 4, 4 } },
+    };
+    static const struct { wchar_t c; char base; } polish[] = {
+        { L'ą', 'a' }, { L'ć', 'c' }, { L'ę', 'e' }, { L'ł', 'l' }, { L'ń', 'n' }, { L'ó', 'o' }, { L'ś', 's' }, { L'ź', 'z' }, { L'ż', 'z' },
+        { L'Ą', 'a' }, { L'Ć', 'c' }, { L'Ę', 'e' }, { L'Ł', 'l' }, { L'Ń', 'n' }, { L'Ó', 'o' }, { L'Ś', 's' }, { L'Ź', 'z' }, { L'Ż', 'z' },
+    };
+
+    for (const auto& p : polish) if (p.c == c) c = p.base;
+    if (c >= L'0' && c <= L'9') return digits[c - L'0'];
+    if (c >= L'a' && c <= L'z') return letters[c - L'a'];
+    if (c >= L'A' && c <= L'Z') return letters[c - L'A'];
+    for (const auto& s : symbols) if (s.c == c) return s.rows;
+    return nullptr;
+}
+
+void SoftwareBackend::DrawLabel(int x, int y, const wstring& text, int size, Argb color) {
+    int scale = max(1, size / 4);
+    for (wchar_t c : text) {
+        const uint8_t* rows = Glyph(c);
+        for (int row = 0; rows && row < 5; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                if (rows[row] & (4 >> col)) FillRectangle({ x + col * scale, y + row * scale, scale, scale }, color);
+            }
+        }
+        x += 4 * scale;
+    }
+}
+
+bool SoftwareBackend::WritePpm(const string& path) const {
+    FILE* out = fopen(path.c_str(), "wb");
+    if (!out) return false;
+    fprintf(out, "P6\n%d %d\n255\n", width, height);
+    vector<unsigned char> row((size_t)width * 3);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            Argb c = frame[(size_t)y * width + x];
+            row[x * 3] = (unsigned char)(c >> 16);
+            row[x * 3 + 1] = (unsigned char)(c >> 8);
+            row[x * 3 + 2] = (unsigned char)c;
+        }
+        fwrite(row.data(), 1, row.size(), out);
+    }
+    return fclose(out) == 0;
+}
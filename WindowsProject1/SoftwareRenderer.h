@@ -0,0 +1,42 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+
+// Rysowanie do bufora pikseli w pamięci, bez okna. Służy do pomiaru kosztu klatki na każdym systemie
+// i do zapisu klatek do plików. Bez wygładzania krawędzi; tekst to prosta czcionka 3x5 (bez polskich znaków).
+class SoftwareBackend : public RenderBackend {
+public:
+    void Resize(int width, int height) override;
+    void BeginBackground() override { target = &background; }
+    void EndBackground() override { target = &frame; }
+    void RestoreBackground(const ScreenRect& rect) override;
+    void SetClip(const ScreenRect& rect) override;
+    void ResetClip() override { clip = { 0, 0, width, height }; }
+
+    void FillRectangle(const ScreenRect& rect, Argb color) override;
+    void FillGradient(const ScreenRect& rect, Argb top, Argb bottom) override;
+    void DrawRectangle(const ScreenRect& rect, Argb color, int width) override;
+    void DrawLine(int x0, int y0, int x1, int y1, Argb color, int width) override;
+    void FillEllipse(const ScreenRect& rect, Argb color) override;
+    void DrawEllipse(const ScreenRect& rect, Argb color, int width) override;
+    void DrawLabel(int x, int y, const std::wstring& text, int size, Argb color) override;
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    const Argb* Pixels() const { return frame.data(); }
+    bool WritePpm(const std::string& path) const;
+
+private:
+    void FillSpan(int x0, int x1, int y, Argb color);
+    void EllipseSpan(const ScreenRect& rect, int y, int& left, int& right) const;
+
+    int width = 0;
+    int height = 0;
+    std::vector<Argb> frame;
+    std::vector<Argb> background;
+    std::vector<Argb>* target = &frame;
+    ScreenRect clip;
+};
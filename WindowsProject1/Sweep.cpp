@@ -0,0 +1,122 @@
+﻿#include "Sweep.h"
+
+#include <cmath>
+#include <memory>
+
+#include "Dispatcher.h"
+#include "EventScheduler.h"
+#include "Simulation.h"
+
+using namespace std;
+
+bool ParseSweepParameter(const string& text, SweepParameter& parameter, string& error) {
+    size_t eq = text.find('=');
+    if (eq == string::npos || eq == 0 || eq + 1 == text.size()) {
+        error = "parametr siatki musi mieć postać klucz=w1,w2,...: " + text;
+        return false;
+    }
+    parameter.key = text.substr(0, eq);
+    parameter.values.clear();
+    size_t begin = eq + 1;
+    while (begin <= text.size()) {
+        size_t end = text.find(',', begin);
+        if (end == string::npos) end = text.size();
+        if (end > begin) parameter.values.push_back(text.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    BuildingConfig probe;
+    for (const auto& value : parameter.values) {
+        if (!SetBuildingConfigValue(probe, parameter.key, value, error)) return false;
+    }
+    return true;
+}
+
+bool BuildSweepGrid(const SweepSpec& spec, vector<BuildingConfig>& grid, string& error) {
+    size_t points = 1;
+    for (const auto& parameter : spec.parameters) points *= parameter.values.size();
+    grid.clear();
+    grid.reserve(points);
+    for (size_t point = 0; point < points; ++point) {
+        BuildingConfig config = spec.base;
+        vector<string> values = GridPointValues(spec, point);
+        for (size_t i = 0; i < spec.parameters.size(); ++i) {
+            if (!SetBuildingConfigValue(config, spec.parameters[i].key, values[i], error)) return false;
+        }
+        if (!ValidateBuildingConfig(config, error)) {
+            error = "punkt siatki " + to_string(point) + ": " + error;
+            return false;
+        }
+        grid.push_back(config);
+    }
+    return true;
+}
+
+vector<string> GridPointValues(const SweepSpec& spec, size_t point) {
+    vector<string> values(spec.parameters.size());
+    for (size_t i = spec.parameters.size(); i-- > 0;) {
+        const auto& options = spec.parameters[i].values;
+        values[i] = options[point % options.size()];
+        point /= options.size();
+    }
+    return values;
+}
+
+// SplitMix64: kolejne powtórzenia dostają niezależne strumienie nawet dla sąsiednich ziaren.
+uint64_t RunSeed(uint64_t baseSeed, int run) {
+    uint64_t z = baseSeed + 0x9E3779B97F4A7C15ull * (uint64_t)(run + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+RunResult RunSimulation(const SweepSpec& spec, const BuildingConfig& config, uint64_t seed) {
+    ManualClock clock;
+    ElevatorBank bank(clock, config, CreateDispatcher(spec.dispatcher));
+    TrafficGenerator traffic(spec.pattern, config.floorCount, spec.arrivalsPerHour, spec.duration, seed);
+    EventScheduler scheduler(bank, clock);
+    scheduler.SetArrivalSource(&traffic);
+    scheduler.Run(spec.maxTime);
+
+    const SimulationMetrics& metrics = bank.metrics;
+    CarStats total = metrics.Total();
+    RunResult result;
+    result.meanWait = metrics.wait.Mean() / 1000.0;
+    result.p95Wait = metrics.wait.Percentile(95) / 1000.0;
+    result.meanJourney = metrics.journey.Mean() / 1000.0;
+    result.p95Journey = metrics.journey.Percentile(95) / 1000.0;
+    result.loadFactor = metrics.LoadFactor(config.CarCapacity());
+    result.delivered = (double)bank.deliveredPassengers;
+    result.floorsPerPassenger = bank.deliveredPassengers ? (double)total.floorsTravelled / bank.deliveredPassengers : 0.0;
+    result.stopsPerTrip = total.trips ? (double)total.stops / total.trips : 0.0;
+    result.handlingCapacity = (double)metrics.HandlingCapacity();
+    return result;
+}
+
+static Estimate EstimateField(const RunResult* runs, int count, double RunResult::* field) {
+    Estimate e;
+    if (count == 0) return e;
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) sum += runs[i].*field;
+    e.mean = sum / count;
+    if (count > 1) {
+        double squares = 0.0;
+        for (int i = 0; i < count; ++i) squares += (runs[i].*field - e.mean) * (runs[i].*field - e.mean);
+        e.stddev = sqrt(squares / (count - 1));
+    }
+    return e;
+}
+
+PointSummary Summarize(const SweepSpec& spec, size_t point, const RunResult* runs) {
+    PointSummary s;
+    s.values = GridPointValues(spec, point);
+    s.meanWait = EstimateField(runs, spec.runs, &RunResult::meanWait);
+    s.p95Wait = EstimateField(runs, spec.runs, &RunResult::p95Wait);
+    s.meanJourney = EstimateField(runs, spec.runs, &RunResult::meanJourney);
+    s.p95Journey = EstimateField(runs, spec.runs, &RunResult::p95Journey);
+    s.loadFactor = EstimateField(runs, spec.runs, &RunResult::loadFactor);
+    s.floorsPerPassenger = EstimateField(runs, spec.runs, &RunResult::floorsPerPassenger);
+    s.stopsPerTrip = EstimateField(runs, spec.runs, &RunResult::stopsPerTrip);
+    s.delivered = EstimateField(runs, spec.runs, &RunResult::delivered);
+    s.handlingCapacity = EstimateField(runs, spec.runs, &RunResult::handlingCapacity);
+    return s;
+}
@@ -0,0 +1,64 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BuildingConfig.h"
+#include "Trace.h"
+
+// Jeden wymiar siatki: klucz jak w pliku konfiguracji i lista wartości.
+struct SweepParameter {
+    std::string key;
+    std::vector<std::string> values;
+};
+
+struct SweepSpec {
+    BuildingConfig base;
+    std::vector<SweepParameter> parameters;
+    std::string dispatcher = "nearest";
+    TrafficPattern pattern = TrafficPattern::INTERFLOOR;
+    double arrivalsPerHour = 600.0;
+    uint32_t duration = 60u * 60u * 1000u;
+    uint32_t maxTime = 0;
+    int runs = 10;
+    uint64_t seed = 1;
+};
+
+// Wynik jednego przebiegu; czasy w sekundach.
+struct RunResult {
+    double meanWait = 0.0;
+    double p95Wait = 0.0;
+    double meanJourney = 0.0;
+    double p95Journey = 0.0;
+    double loadFactor = 0.0;
+    double floorsPerPassenger = 0.0;
+    double stopsPerTrip = 0.0;
+    double delivered = 0.0;
+    // Osoby na 5 minut (SimulationMetrics::HandlingCapacity).
+    double handlingCapacity = 0.0;
+};
+
+struct Estimate {
+    double mean = 0.0;
+    double stddev = 0.0;
+};
+
+// Średnie i odchylenia standardowe wszystkich przebiegów jednego punktu siatki.
+struct PointSummary {
+    std::vector<std::string> values;
+    Estimate meanWait, p95Wait, meanJourney, p95Journey, loadFactor, floorsPerPassenger, stopsPerTrip, delivered, handlingCapacity;
+};
+
+// "klucz=w1,w2,w3"
+bool ParseSweepParameter(const std::string& text, SweepParameter& parameter, std::string& error);
+// Wszystkie kombinacje wartości parametrów; ostatni parametr zmienia się najszybciej.
+bool BuildSweepGrid(const SweepSpec& spec, std::vector<BuildingConfig>& grid, std::string& error);
+std::vector<std::string> GridPointValues(const SweepSpec& spec, size_t point);
+
+// Ziarno ruchu zależy tylko od numeru powtórzenia, więc każdy punkt siatki dostaje ten sam ruch
+// (wspólne liczby losowe) i różnice między punktami nie wynikają z losowania.
+uint64_t RunSeed(uint64_t baseSeed, int run);
+RunResult RunSimulation(const SweepSpec& spec, const BuildingConfig& config, uint64_t seed);
+// Kolejność przebiegów nie wpływa na wynik, bo są sumowane dopiero po zakończeniu wszystkich.
+PointSummary Summarize(const SweepSpec& spec, size_t point, const RunResult* runs);
@@ -0,0 +1,136 @@
+﻿#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Dispatcher.h"
+#include "Sweep.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+void PrintUsage(const char* name) {
+    fprintf(stderr,
+        "Użycie: %s --vary klucz=w1,w2,... [--vary ...] [--runs N] [--threads N] [--seed S]\n"
+        "          [--traffic poisson|up-peak|down-peak|lunch] [--rate N] [--duration MS] [--max-time MS]\n"
+        "          [--config plik] [--dispatcher nearest|eta|destination] [--out plik.csv]\n"
+        "  --vary      parametr siatki, klucze jak w pliku konfiguracji, np. --vary door_open_ms=1000,1500,2000\n"
+        "  --runs      liczba przebiegów w każdym punkcie siatki (domyślnie 10)\n"
+        "  --threads   liczba wątków (domyślnie liczba rdzeni)\n",
+        name);
+}
+
+static void WriteEstimate(FILE* out, const Estimate& e) {
+    fprintf(out, ",%.3f,%.3f", e.mean, e.stddev);
+}
+
+int main(int argc, char** argv) {
+    SweepSpec spec;
+    const char* configPath = nullptr;
+    const char* trafficName = "poisson";
+    const char* outPath = nullptr;
+    int threads = 0;
+    string error;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--vary") && i + 1 < argc) {
+            SweepParameter parameter;
+            if (!ParseSweepParameter(argv[++i], parameter, error)) {
+                fprintf(stderr, "Błąd siatki: %s\n", error.c_str());
+                return 1;
+            }
+            spec.parameters.push_back(parameter);
+        }
+        else if (!strcmp(argv[i], "--runs") && i + 1 < argc) spec.runs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) spec.seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--traffic") && i + 1 < argc) trafficName = argv[++i];
+        else if (!strcmp(argv[i], "--rate") && i + 1 < argc) spec.arrivalsPerHour = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--duration") && i + 1 < argc) spec.duration = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--max-time") && i + 1 < argc) spec.maxTime = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--config") && i + 1 < argc) configPath = argv[++i];
+        else if (!strcmp(argv[i], "--dispatcher") && i + 1 < argc) spec.dispatcher = argv[++i];
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) outPath = argv[++i];
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (configPath && !LoadBuildingConfig(configPath, spec.base, error)) {
+        fprintf(stderr, "Błąd konfiguracji: %s\n", error.c_str());
+        return 1;
+    }
+    if (!ParseTrafficPattern(trafficName, spec.pattern) || spec.arrivalsPerHour <= 0 || spec.runs < 1) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    if (!CreateDispatcher(spec.dispatcher)) {
+        fprintf(stderr, "Nieznany dyspozytor: %s\n", spec.dispatcher.c_str());
+        return 1;
+    }
+    vector<BuildingConfig> grid;
+    if (!BuildSweepGrid(spec, grid, error)) {
+        fprintf(stderr, "Błąd siatki: %s\n", error.c_str());
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (outPath) {
+        out = fopen(outPath, "w");
+        if (!out) {
+            fprintf(stderr, "Nie można utworzyć pliku %s\n", outPath);
+            return 1;
+        }
+    }
+
+    // Przebieg i to punkt i / runs, powtórzenie i % runs; wyniki trafiają na stałe miejsca w tablicy.
+    size_t runCount = grid.size() * spec.runs;
+    vector<RunResult> results(runCount);
+    ThreadPool pool(threads);
+    auto wallStart = chrono::steady_clock::now();
+    pool.ParallelFor(runCount, [&](size_t i) {
+        int run = (int)(i % spec.runs);
+        results[i] = RunSimulation(spec, grid[i / spec.runs], RunSeed(spec.seed, run));
+    });
+    double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+
+    for (const auto& parameter : spec.parameters) fprintf(out, "%s,", parameter.key.c_str());
+    fputs("runs", out);
+    for (const char* name : { "wait_mean", "wait_p95", "journey_mean", "journey_p95", "load_factor", "floors_per_passenger",
+        "stops_per_trip", "delivered", "handling_capacity" }) {
+        fprintf(out, ",%s,%s_sd", name, name);
+    }
+    fputc('\n', out);
+    size_t best = 0;
+    double bestJourney = 0.0;
+    for (size_t point = 0; point < grid.size(); ++point) {
+        PointSummary s = Summarize(spec, point, &results[point * spec.runs]);
+        for (const auto& value : s.values) fprintf(out, "%s,", value.c_str());
+        fprintf(out, "%d", spec.runs);
+        for (const Estimate* e : { &s.meanWait, &s.p95Wait, &s.meanJourney, &s.p95Journey, &s.loadFactor,
+            &s.floorsPerPassenger, &s.stopsPerTrip, &s.delivered, &s.handlingCapacity }) {
+            WriteEstimate(out, *e);
+        }
+        fputc('\n', out);
+        if (point == 0 || s.meanJourney.mean < bestJourney) {
+            best = point;
+            bestJourney = s.meanJourney.mean;
+        }
+    }
+    if (out != stdout && fclose(out) != 0) {
+        fprintf(stderr, "Nie można zapisać pliku %s\n", outPath);
+        return 1;
+    }
+
+    fprintf(stderr, "Punkty siatki: %zu, przebiegi: %zu, wątki: %d\n", grid.size(), runCount, pool.ThreadCount());
+    fprintf(stderr, "Czas rzeczywisty: %.3f s (%.1f przebiegów/s)\n", wallSeconds, wallSeconds > 0 ? runCount / wallSeconds : 0.0);
+    fprintf(stderr, "Najkrótsza średnia podróż: %.1f s przy", bestJourney);
+    vector<string> values = GridPointValues(spec, best);
+    for (size_t i = 0; i < values.size(); ++i) fprintf(stderr, " %s=%s", spec.parameters[i].key.c_str(), values[i].c_str());
+    fputc('\n', stderr);
+    return 0;
+}
@@ -0,0 +1,86 @@
+﻿#include "ThreadPool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount <= 0) threadCount = (int)thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    for (int i = 0; i < threadCount; ++i) queues.push_back(make_unique<WorkQueue>());
+    for (int i = 0; i < threadCount; ++i) workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::ParallelFor(size_t count, const function<void(size_t)>& task) {
+    if (count == 0) return;
+    unique_lock<std::mutex> lock(stateMutex);
+    this->task = &task;
+    remaining = count;
+    size_t threads = queues.size();
+    for (size_t w = 0; w < threads; ++w) {
+        lock_guard<std::mutex> queueLock(queues[w]->mutex);
+        for (size_t i = w * count / threads; i < (w + 1) * count / threads; ++i) queues[w]->items.push_back(i);
+    }
+    generation++;
+    wake.notify_all();
+    // Wątek, który wciąż trzyma wskaźnik do zadania, nie może go zobaczyć po powrocie z ParallelFor.
+    finished.wait(lock, [this] { return remaining == 0 && activeWorkers == 0; });
+    this->task = nullptr;
+}
+
+bool ThreadPool::TakeWork(int index, size_t& item) {
+    {
+        WorkQueue& own = *queues[index];
+        lock_guard<std::mutex> lock(own.mutex);
+        if (!own.items.empty()) {
+            item = own.items.back();
+            own.items.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); ++i) {
+        WorkQueue& victim = *queues[(index + i) % queues.size()];
+        lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.items.empty()) {
+            item = victim.items.front();
+            victim.items.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(int index) {
+    unsigned seen = 0;
+    while (true) {
+        const function<void(size_t)>* current;
+        {
+            unique_lock<std::mutex> lock(stateMutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            current = task;
+            activeWorkers++;
+        }
+
+        size_t done = 0;
+        size_t item;
+        // Wątek obudzony po zakończeniu poprzedniego ParallelFor nie ma zadania, a kolejki mogą już należeć do następnego.
+        while (current && TakeWork(index, item)) {
+            (*current)(item);
+            done++;
+        }
+
+        lock_guard<std::mutex> lock(stateMutex);
+        remaining -= done;
+        activeWorkers--;
+        if (remaining == 0 && activeWorkers == 0) finished.notify_all();
+    }
+}
@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pula wątków z podkradaniem pracy. Każdy wątek dostaje ciągły zakres zadań we własnej kolejce
+// i bierze je od końca; gdy jego kolejka się opróżni, zabiera zadania z początku kolejki innego wątku.
+class ThreadPool {
+public:
+    // threadCount <= 0 oznacza liczbę rdzeni.
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int ThreadCount() const { return (int)workers.size(); }
+    // Wywołuje task(i) dla każdego i < count i czeka, aż wszystkie zadania się skończą.
+    void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<size_t> items;
+    };
+
+    void WorkerLoop(int index);
+    bool TakeWork(int index, size_t& item);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* task = nullptr;
+    unsigned generation = 0;
+    size_t remaining = 0;
+    int activeWorkers = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,324 @@
+﻿#include "Trace.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const size_t RELEASE_STEP = 64u << 20;
+
+uint64_t TraceSource::Skip(uint64_t count) {
+    TraceRecord record;
+    uint64_t skipped = 0;
+    while (skipped < count && Next(record)) skipped++;
+    return skipped;
+}
+
+bool TraceBuffer::Next(TraceRecord& record) {
+    if (next >= records.size()) return false;
+    record = records[next++];
+    return true;
+}
+
+uint64_t TraceBuffer::Skip(uint64_t count) {
+    uint64_t skipped = min<uint64_t>(count, records.size() - next);
+    next += (size_t)skipped;
+    return skipped;
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+#else
+    if (data) munmap((void*)data, size);
+#endif
+}
+
+bool MappedFile::Open(const string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    fileHandle = file;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) return false;
+    size = (size_t)fileSize.QuadPart;
+    if (size == 0) return true;
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) return false;
+    data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    return data != nullptr;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    size = (size_t)st.st_size;
+    if (size == 0) {
+        close(fd);
+        return true;
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    data = (const char*)mapped;
+    return true;
+#endif
+}
+
+void MappedFile::Release(size_t upTo) {
+    if (upTo < released + RELEASE_STEP) return;
+    size_t end = upTo / RELEASE_STEP * RELEASE_STEP;
+#ifdef _WIN32
+    // FILE_FLAG_SEQUENTIAL_SCAN dotyczy tylko pamięci podręcznej plików, nie stron widoku. VirtualUnlock na
+    // niezablokowanym zakresie usuwa jego strony z zestawu roboczego procesu (zwraca wtedy FALSE
+    // z ERROR_NOT_LOCKED, czego nie traktujemy jako błędu); strony widoku tylko do odczytu nie są brudne,
+    // więc system po prostu je odrzuca, a ponowny odczyt wczytałby je z pliku.
+    VirtualUnlock((void*)(data + released), end - released);
+#else
+    madvise((void*)(data + released), end - released, MADV_DONTNEED);
+#endif
+    released = end;
+}
+
+static uint32_t ReadU32(const char* p) {
+    const unsigned char* b = (const unsigned char*)p;
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static uint16_t ReadU16(const char* p) {
+    const unsigned char* b = (const unsigned char*)p;
+    return (uint16_t)(b[0] | (b[1] << 8));
+}
+
+static void WriteU32(char* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = (char)(v >> (8 * i));
+}
+
+static void WriteU16(char* p, uint16_t v) {
+    p[0] = (char)v;
+    p[1] = (char)(v >> 8);
+}
+
+bool BinaryTraceReader::Open(const string& path, string& error) {
+    if (!file.Open(path)) {
+        error = "nie można otworzyć pliku " + path;
+        return false;
+    }
+    if (file.Size() < TRACE_HEADER_SIZE || memcmp(file.Data(), TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        error = path + ": to nie jest binarny plik ruchu";
+        return false;
+    }
+    if (ReadU32(file.Data() + 8) != TRACE_VERSION) {
+        error = path + ": nieobsługiwana wersja pliku ruchu";
+        return false;
+    }
+    floorCount = ReadU32(file.Data() + 12);
+    offset = TRACE_HEADER_SIZE;
+    return true;
+}
+
+bool BinaryTraceReader::Next(TraceRecord& record) {
+    if (offset + TRACE_RECORD_SIZE > file.Size()) return false;
+    const char* p = file.Data() + offset;
+    record.time = ReadU32(p);
+    record.startFloor = ReadU16(p + 4);
+    record.targetFloor = ReadU16(p + 6);
+    offset += TRACE_RECORD_SIZE;
+    file.Release(offset);
+    return true;
+}
+
+// Rekordy mają stały rozmiar, więc pominięcie nie czyta pliku.
+uint64_t BinaryTraceReader::Skip(uint64_t count) {
+    uint64_t skipped = min<uint64_t>(count, (file.Size() - offset) / TRACE_RECORD_SIZE);
+    offset += (size_t)(skipped * TRACE_RECORD_SIZE);
+    file.Release(offset);
+    return skipped;
+}
+
+bool CsvTraceReader::Open(const string& path, string& error) {
+    if (!file.Open(path)) {
+        error = "nie można otworzyć pliku " + path;
+        return false;
+    }
+    return true;
+}
+
+static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+static bool IsSeparator(char c) { return c == ',' || c == ' ' || c == '\t' || c == ';'; }
+
+bool CsvTraceReader::Next(TraceRecord& record) {
+    const char* data = file.Data();
+    size_t size = file.Size();
+    while (offset < size) {
+        size_t p = offset;
+        unsigned long long fields[3];
+        int count = 0;
+        bool valid = true;
+        while (count < 3 && valid) {
+            while (p < size && IsSeparator(data[p])) p++;
+            if (p >= size || !IsDigit(data[p])) {
+                valid = false;
+                break;
+            }
+            unsigned long long value = 0;
+            while (p < size && IsDigit(data[p])) value = value * 10 + (data[p++] - '0');
+            fields[count++] = value;
+        }
+        while (p < size && data[p] != '\n') p++;
+        offset = p + 1;
+        file.Release(offset);
+        if (!valid || fields[0] > UINT32_MAX || fields[1] > UINT16_MAX || fields[2] > UINT16_MAX) continue;
+        record.time = (uint32_t)fields[0];
+        record.startFloor = (uint16_t)fields[1];
+        record.targetFloor = (uint16_t)fields[2];
+        return true;
+    }
+    return false;
+}
+
+unique_ptr<TraceSource> OpenTrace(const string& path, string& error) {
+    char magic[sizeof(TRACE_MAGIC)] = {};
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        error = "nie można otworzyć pliku " + path;
+        return nullptr;
+    }
+    size_t read = fread(magic, 1, sizeof(magic), f);
+    fclose(f);
+
+    if (read == sizeof(magic) && memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0) {
+        auto reader = make_unique<BinaryTraceReader>();
+        if (!reader->Open(path, error)) return nullptr;
+        return reader;
+    }
+    auto reader = make_unique<CsvTraceReader>();
+    if (!reader->Open(path, error)) return nullptr;
+    return reader;
+}
+
+TraceWriter::~TraceWriter() {
+    Close();
+}
+
+bool TraceWriter::Open(const string& path, bool binary, uint32_t floorCount, string& error) {
+    out = fopen(path.c_str(), binary ? "wb" : "w");
+    if (!out) {
+        error = "nie można utworzyć pliku " + path;
+        return false;
+    }
+    this->binary = binary;
+    buffer.resize(1 << 20);
+    setvbuf(out, buffer.data(), _IOFBF, buffer.size());
+    if (binary) {
+        char header[TRACE_HEADER_SIZE];
+        memcpy(header, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        WriteU32(header + 8, TRACE_VERSION);
+        WriteU32(header + 12, floorCount);
+        fwrite(header, 1, sizeof(header), out);
+    }
+    else {
+        fputs("time_ms,start,target\n", out);
+    }
+    return true;
+}
+
+void TraceWriter::Write(const TraceRecord& record) {
+    if (binary) {
+        char bytes[TRACE_RECORD_SIZE];
+        WriteU32(bytes, record.time);
+        WriteU16(bytes + 4, record.startFloor);
+        WriteU16(bytes + 6, record.targetFloor);
+        fwrite(bytes, 1, sizeof(bytes), out);
+    }
+    else {
+        fprintf(out, "%u,%u,%u\n", (unsigned)record.time, (unsigned)record.startFloor, (unsigned)record.targetFloor);
+    }
+}
+
+bool TraceWriter::Close() {
+    if (!out) return true;
+    bool ok = fclose(out) == 0;
+    out = nullptr;
+    return ok;
+}
+
+TrafficGenerator::TrafficGenerator(TrafficPattern pattern, int floorCount, double arrivalsPerHour, uint32_t duration, uint64_t seed)
+    : pattern(pattern), floorCount(floorCount), duration(duration), rng(seed), gap(arrivalsPerHour / 3600000.0), unit(0.0, 1.0) {
+}
+
+// Udziały kursów z parteru, na parter i między piętrami dla każdego wzorca.
+void TrafficGenerator::RandomTrip(int& start, int& target) {
+    double incoming = 0.0, outgoing = 0.0;
+    switch (pattern) {
+    case TrafficPattern::INTERFLOOR: break;
+    case TrafficPattern::UP_PEAK: incoming = 0.9; break;
+    case TrafficPattern::DOWN_PEAK: outgoing = 0.9; break;
+    case TrafficPattern::LUNCH: incoming = 0.4; outgoing = 0.4; break;
+    }
+
+    uniform_int_distribution<int> upperFloor(1, floorCount - 1);
+    double r = unit(rng);
+    if (r < incoming) {
+        start = 0;
+        target = upperFloor(rng);
+    }
+    else if (r < incoming + outgoing) {
+        start = upperFloor(rng);
+        target = 0;
+    }
+    else {
+        uniform_int_distribution<int> anyFloor(0, floorCount - 1);
+        start = anyFloor(rng);
+        do target = anyFloor(rng); while (target == start);
+    }
+}
+
+bool TrafficGenerator::Next(TraceRecord& record) {
+    time += gap(rng);
+    if (time > duration) return false;
+    int start, target;
+    RandomTrip(start, target);
+    record.time = (uint32_t)time;
+    record.startFloor = (uint16_t)start;
+    record.targetFloor = (uint16_t)target;
+    return true;
+}
+
+const char* TrafficPatternName(TrafficPattern pattern) {
+    switch (pattern) {
+    case TrafficPattern::INTERFLOOR: return "poisson";
+    case TrafficPattern::UP_PEAK: return "up-peak";
+    case TrafficPattern::DOWN_PEAK: return "down-peak";
+    case TrafficPattern::LUNCH: return "lunch";
+    }
+    return "?";
+}
+
+bool ParseTrafficPattern(const string& name, TrafficPattern& pattern) {
+    for (TrafficPattern p : { TrafficPattern::INTERFLOOR, TrafficPattern::UP_PEAK, TrafficPattern::DOWN_PEAK, TrafficPattern::LUNCH }) {
+        if (name == TrafficPatternName(p)) {
+            pattern = p;
+            return true;
+        }
+    }
+    return false;
+}
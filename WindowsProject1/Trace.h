@@ -0,0 +1,132 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Jedno przyjście pasażera. Piętra jak w oknie: 0 to parter.
+struct TraceRecord {
+    uint32_t time;
+    uint16_t startFloor;
+    uint16_t targetFloor;
+};
+
+// Plik binarny: nagłówek TRACE_HEADER_SIZE bajtów ("ELVTRACE", wersja, liczba pięter lub 0),
+// potem rekordy po TRACE_RECORD_SIZE bajtów (czas, piętro startowe, piętro docelowe, little-endian).
+const char TRACE_MAGIC[8] = { 'E', 'L', 'V', 'T', 'R', 'A', 'C', 'E' };
+const uint32_t TRACE_VERSION = 1;
+const size_t TRACE_HEADER_SIZE = 16;
+const size_t TRACE_RECORD_SIZE = 8;
+
+// Strumień przyjść uporządkowany według czasu. Next zwraca false, gdy strumień się skończył.
+class TraceSource {
+public:
+    virtual ~TraceSource() = default;
+    virtual bool Next(TraceRecord& record) = 0;
+    // Pomija count rekordów (np. przy wznowieniu z zapisanego stanu) i zwraca, ile faktycznie pominięto.
+    virtual uint64_t Skip(uint64_t count);
+};
+
+// Przyjścia trzymane w pamięci (np. wylosowane opcją --random).
+class TraceBuffer : public TraceSource {
+public:
+    explicit TraceBuffer(std::vector<TraceRecord> records) : records(std::move(records)) {}
+    bool Next(TraceRecord& record) override;
+    uint64_t Skip(uint64_t count) override;
+private:
+    std::vector<TraceRecord> records;
+    size_t next = 0;
+};
+
+// Plik odwzorowany w pamięci. Release zwalnia strony, które czytnik ma już za sobą,
+// więc nawet wielogigabajtowy plik zajmuje stałą ilość pamięci.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    bool Open(const std::string& path);
+    const char* Data() const { return data; }
+    size_t Size() const { return size; }
+    void Release(size_t upTo);
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t released = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+class BinaryTraceReader : public TraceSource {
+public:
+    bool Open(const std::string& path, std::string& error);
+    bool Next(TraceRecord& record) override;
+    uint64_t Skip(uint64_t count) override;
+    uint32_t FloorCount() const { return floorCount; }
+private:
+    MappedFile file;
+    size_t offset = 0;
+    uint32_t floorCount = 0;
+};
+
+// Linie "czas_ms,piętro_startowe,piętro_docelowe". Zamiast przecinka może być spacja, tabulator lub średnik.
+// Linie, które nie zaczynają się od cyfry (nagłówek, komentarz #), są pomijane.
+class CsvTraceReader : public TraceSource {
+public:
+    bool Open(const std::string& path, std::string& error);
+    bool Next(TraceRecord& record) override;
+private:
+    MappedFile file;
+    size_t offset = 0;
+};
+
+// Rozpoznaje format po nagłówku pliku.
+std::unique_ptr<TraceSource> OpenTrace(const std::string& path, std::string& error);
+
+class TraceWriter {
+public:
+    ~TraceWriter();
+    bool Open(const std::string& path, bool binary, uint32_t floorCount, std::string& error);
+    void Write(const TraceRecord& record);
+    bool Close();
+private:
+    FILE* out = nullptr;
+    bool binary = false;
+    std::vector<char> buffer;
+};
+
+enum class TrafficPattern {
+    INTERFLOOR,
+    UP_PEAK,
+    DOWN_PEAK,
+    LUNCH
+};
+
+// Przyjścia jako proces Poissona o zadanej intensywności. Wzorzec decyduje o piętrach:
+// rano większość jedzie z parteru w górę, po pracy na parter, w porze obiadu w obie strony.
+class TrafficGenerator : public TraceSource {
+public:
+    TrafficGenerator(TrafficPattern pattern, int floorCount, double arrivalsPerHour, uint32_t duration, uint64_t seed);
+    bool Next(TraceRecord& record) override;
+private:
+    void RandomTrip(int& start, int& target);
+
+    TrafficPattern pattern;
+    int floorCount;
+    uint32_t duration;
+    double time = 0.0;
+    std::mt19937_64 rng;
+    std::exponential_distribution<double> gap;
+    std::uniform_real_distribution<double> unit;
+};
+
+const char* TrafficPatternName(TrafficPattern pattern);
+bool ParseTrafficPattern(const std::string& name, TrafficPattern& pattern);
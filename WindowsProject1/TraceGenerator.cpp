@@ -0,0 +1,112 @@
+﻿#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "Trace.h"
+
+using namespace std;
+
+void PrintUsage(const char* name) {
+    fprintf(stderr,
+        "Użycie: %s --pattern poisson|up-peak|down-peak|lunch [--rate N] [--duration MS] [--floors N] [--seed S] [--csv] plik\n"
+        "       %s --convert wejście wyjście [--csv]\n"
+        "       %s --scan plik\n"
+        "  --rate      przyjścia na godzinę (domyślnie 600)\n"
+        "  --csv       zapis jako CSV zamiast formatu binarnego\n"
+        "  --scan      czyta cały plik i podaje szybkość odczytu\n",
+        name, name, name);
+}
+
+int main(int argc, char** argv) {
+    const char* patternName = nullptr;
+    const char* convertPath = nullptr;
+    const char* scanPath = nullptr;
+    const char* outPath = nullptr;
+    double rate = 600.0;
+    uint32_t duration = 24u * 60u * 60u * 1000u;
+    int floorCount = 4;
+    unsigned seed = 1;
+    bool csv = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--pattern") && i + 1 < argc) patternName = argv[++i];
+        else if (!strcmp(argv[i], "--rate") && i + 1 < argc) rate = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--duration") && i + 1 < argc) duration = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--floors") && i + 1 < argc) floorCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--csv")) csv = true;
+        else if (!strcmp(argv[i], "--convert") && i + 1 < argc) convertPath = argv[++i];
+        else if (!strcmp(argv[i], "--scan") && i + 1 < argc) scanPath = argv[++i];
+        else if (argv[i][0] != '-' && !outPath) outPath = argv[i];
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    string error;
+    if (scanPath) {
+        unique_ptr<TraceSource> source = OpenTrace(scanPath, error);
+        if (!source) {
+            fprintf(stderr, "Błąd pliku ruchu: %s\n", error.c_str());
+            return 1;
+        }
+        auto start = chrono::steady_clock::now();
+        TraceRecord record;
+        uint64_t count = 0, checksum = 0;
+        while (source->Next(record)) {
+            count++;
+            checksum += record.time ^ ((uint32_t)record.startFloor << 16 | record.targetFloor);
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("Rekordy:        %llu\n", (unsigned long long)count);
+        printf("Czas odczytu:   %.3f s\n", seconds);
+        if (seconds > 0) printf("Szybkość:       %.1f mln rekordów/s\n", count / seconds / 1e6);
+        printf("Suma kontrolna: %llu\n", (unsigned long long)checksum);
+        return 0;
+    }
+
+    if (!outPath || floorCount < 2 || floorCount > 65536 || rate <= 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    unique_ptr<TraceSource> source;
+    if (convertPath) {
+        source = OpenTrace(convertPath, error);
+        if (!source) {
+            fprintf(stderr, "Błąd pliku ruchu: %s\n", error.c_str());
+            return 1;
+        }
+        floorCount = 0;
+    }
+    else {
+        TrafficPattern pattern;
+        if (!patternName || !ParseTrafficPattern(patternName, pattern)) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        source = make_unique<TrafficGenerator>(pattern, floorCount, rate, duration, seed);
+    }
+
+    TraceWriter writer;
+    if (!writer.Open(outPath, !csv, (uint32_t)floorCount, error)) {
+        fprintf(stderr, "Błąd zapisu: %s\n", error.c_str());
+        return 1;
+    }
+    TraceRecord record;
+    uint64_t count = 0;
+    while (source->Next(record)) {
+        writer.Write(record);
+        count++;
+    }
+    if (!writer.Close()) {
+        fprintf(stderr, "Błąd zapisu: %s\n", outPath);
+        return 1;
+    }
+    printf("Zapisano %llu przyjść do %s\n", (unsigned long long)count, outPath);
+    return 0;
+}
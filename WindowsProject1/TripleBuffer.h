@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include <atomic>
+
+// Przekazywanie najnowszego stanu z jednego wątku do drugiego bez blokad. Piszący wypełnia swój bufor
+// i zamienia go ze środkowym; czytający zamienia swój ze środkowym tylko wtedy, gdy ten jest nowy.
+// Żaden wątek nie czeka na drugi, a pośrednie stany, których czytający nie zdążył odebrać, przepadają.
+template <typename T>
+class TripleBuffer {
+public:
+    T& WriteBuffer() { return slots[writeIndex]; }
+    void Publish() { writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK; }
+
+    // Zwraca true, jeśli od poprzedniego wywołania opublikowano nowy stan.
+    bool Update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T& ReadBuffer() const { return slots[readIndex]; }
+
+private:
+    static constexpr int FRESH = 4;
+    static constexpr int INDEX_MASK = 3;
+
+    T slots[3];
+    alignas(64) int writeIndex = 0;
+    alignas(64) std::atomic<int> middle{ 1 };
+    alignas(64) int readIndex = 2;
+};
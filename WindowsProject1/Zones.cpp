@@ -0,0 +1,144 @@
+﻿#include "Zones.h"
+
+#include <cstdlib>
+
+using namespace std;
+
+static string Trim(const string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+// "N" albo "N-M".
+static bool ParseRange(const string& text, int& first, int& last) {
+    string s = Trim(text);
+    if (s.empty()) return false;
+    char* end;
+    first = (int)strtol(s.c_str(), &end, 10);
+    last = first;
+    if (*end == '-') last = (int)strtol(end + 1, &end, 10);
+    return *end == '\0' && first >= 0 && last >= first;
+}
+
+bool ParseCarZone(const string& text, CarZone& zone, string& error) {
+    vector<string> parts;
+    size_t begin = 0;
+    while (true) {
+        size_t colon = text.find(':', begin);
+        parts.push_back(Trim(text.substr(begin, colon == string::npos ? string::npos : colon - begin)));
+        if (colon == string::npos) break;
+        begin = colon + 1;
+    }
+    if (parts.size() < 2 || parts.size() > 3) {
+        error = "strefa to 'kabiny : piętra [: double]'";
+        return false;
+    }
+
+    zone = CarZone();
+    if (!ParseRange(parts[0], zone.firstCar, zone.lastCar)) {
+        error = "złe kabiny strefy '" + parts[0] + "'";
+        return false;
+    }
+    begin = 0;
+    while (true) {
+        size_t comma = parts[1].find(',', begin);
+        string item = parts[1].substr(begin, comma == string::npos ? string::npos : comma - begin);
+        int first, last;
+        if (!ParseRange(item, first, last)) {
+            error = "złe piętra strefy '" + parts[1] + "'";
+            return false;
+        }
+        for (int label = first; label <= last; ++label) zone.floors.push_back(label);
+        if (comma == string::npos) break;
+        begin = comma + 1;
+    }
+    if (parts.size() == 3) {
+        if (parts[2] == "double") zone.doubleDeck = true;
+        else if (parts[2] != "single") {
+            error = "nieznany rodzaj kabiny '" + parts[2] + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+ZoneRoutes::ZoneRoutes(int floorCount, int carCount, const vector<CarZone>& zones) : floorCount(floorCount) {
+    int ground = floorCount - 1;
+    size_t size = (size_t)floorCount * floorCount;
+
+    // Każda strefa i osobno kabiny spoza stref.
+    struct Group {
+        vector<char> served;
+        bool doubleDeck;
+    };
+    vector<Group> groups;
+    vector<char> zoned(carCount, 0);
+    for (const auto& zone : zones) {
+        Group group = { vector<char>(floorCount, 0), zone.doubleDeck };
+        for (int label : zone.floors) {
+            if (label < floorCount) group.served[ground - label] = 1;
+        }
+        for (int car = zone.firstCar; car <= zone.lastCar && car < carCount; ++car) zoned[car] = 1;
+        groups.push_back(move(group));
+    }
+    for (char z : zoned) {
+        if (z) continue;
+        groups.push_back({ vector<char>(floorCount, 1), false });
+        break;
+    }
+
+    vector<char> direct(size, 0);
+    vector<int> servedBy(floorCount, 0);
+    for (const auto& group : groups) {
+        for (int start = 0; start < floorCount; ++start) {
+            if (!group.served[start]) continue;
+            servedBy[start]++;
+            for (int target = 0; target < floorCount; ++target) {
+                if (!group.served[target]) continue;
+                if (group.doubleDeck && DeckStopFloor(start, ground) == DeckStopFloor(target, ground)) continue;
+                direct[(size_t)start * floorCount + target] = 1;
+            }
+        }
+    }
+    // Przesiadka jest możliwa tylko tam, gdzie stają co najmniej dwie strefy.
+    vector<int> hubs;
+    for (int floor = 0; floor < floorCount; ++floor) {
+        if (servedBy[floor] > 1) hubs.push_back(floor);
+    }
+
+    transfer.assign(size, NONE);
+    for (int start = 0; start < floorCount; ++start) {
+        for (int target = 0; target < floorCount; ++target) {
+            int& route = transfer[(size_t)start * floorCount + target];
+            if (start == target || direct[(size_t)start * floorCount + target]) {
+                route = DIRECT;
+                continue;
+            }
+            if (DeckStopFloor(start, ground) == DeckStopFloor(target, ground)) {
+                route = WALK;
+                continue;
+            }
+            int bestLength = 0;
+            for (int hub : hubs) {
+                if (!direct[(size_t)start * floorCount + hub] || !direct[(size_t)hub * floorCount + target]) continue;
+                int length = abs(start - hub) + abs(hub - target);
+                if (route == NONE || length < bestLength) {
+                    route = hub;
+                    bestLength = length;
+                }
+            }
+        }
+    }
+}
+
+bool ZoneRoutes::FindUnreachable(int& startFloor, int& targetFloor) const {
+    for (size_t i = 0; i < transfer.size(); ++i) {
+        if (transfer[i] != NONE) continue;
+        startFloor = (int)(i / floorCount);
+        targetFloor = (int)(i % floorCount);
+        return true;
+    }
+    return false;
+}
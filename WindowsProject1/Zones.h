@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+// Strefa: kabiny firstCar..lastCar stają tylko na piętrach floors (etykiety, 0 = parter). Piętra między
+// obsługiwanymi kabina mija bez zatrzymania, więc strefa wysoka z parterem to jazda ekspresowa. Kabina
+// dwupokładowa ma pokład dolny na piętrze parzystym i górny o piętro wyżej; jeden postój obsługuje oba.
+struct CarZone {
+    int firstCar = 0;
+    int lastCar = 0;
+    std::vector<int> floors;
+    bool doubleDeck = false;
+};
+
+// "kabiny : piętra [: double]", np. "0-3 : 0-15" albo "4-5 : 0,16-30 : double".
+bool ParseCarZone(const std::string& text, CarZone& zone, std::string& error);
+
+// Piętro, na którym staje pokład dolny kabiny dwupokładowej obsługującej floor (indeks od góry).
+inline int DeckStopFloor(int floor, int groundFloor) {
+    return groundFloor - ((groundFloor - floor) & ~1);
+}
+
+// Trasy między strefami, liczone raz dla wszystkich par pięter: jazda wprost, z jedną przesiadką na piętrze
+// obsługiwanym przez obie strefy (najkrótsza droga, np. przez hol przesiadkowy) albo pieszo, gdy oba piętra
+// są w jednej parze pokładów. Kabiny spoza stref obsługują wszystkie piętra.
+class ZoneRoutes {
+public:
+    static constexpr int DIRECT = -1;
+    static constexpr int WALK = -2;
+    static constexpr int NONE = -3;
+
+    ZoneRoutes() = default;
+    ZoneRoutes(int floorCount, int carCount, const std::vector<CarZone>& zones);
+
+    bool Empty() const { return transfer.empty(); }
+    // Piętro przesiadki albo DIRECT, WALK lub NONE.
+    int Transfer(int startFloor, int targetFloor) const { return transfer[(size_t)startFloor * floorCount + targetFloor]; }
+    // Pierwsza para pięter bez trasy; false, gdy każda ma trasę.
+    bool FindUnreachable(int& startFloor, int& targetFloor) const;
+
+private:
+    int floorCount = 0;
+    std::vector<int> transfer;
+};